@@ -2,34 +2,71 @@
 #include <cmath>
 #include <iomanip>
 #include <string>
-#include <functional>
+#include <stdexcept>
+
+#include "batch_io.h"
+#include "expression.h"
+#include "root_finding.h"
 
 using namespace std;
 
-// Function to evaluate a given expression at x
-double evaluate_expression(const string& expr_str, double x) {
-    // Simple parsing for demonstration, assuming basic arithmetic operations and functions
-    // You may need to enhance this for more complex expressions
-    string expr = expr_str;
-    size_t pos = expr.find("x");
-    while (pos != string::npos) {
-        expr.replace(pos, 1, to_string(x));
-        pos = expr.find("x", pos + 1);
+// Batch mode: each record is one line "x0 epsilon maxIterations f(x) ; f'(x)".
+// The output line is "root iterations", or "error ..." when the derivative
+// vanishes or the root is not reached. Formulas equal to those of the
+// previous record are not parsed again.
+int runBatch(const string& path) {
+    RecordWriter out(cout);
+    try {
+        RecordReader in(path);
+        string previous;
+        Expression f, fprime;
+        bool compiled = false;
+        while (!in.atEnd()) {
+            double x0 = in.number();
+            double epsilon = in.number();
+            int maxIterations = in.integer();
+            string formulas = in.textLine();
+            try {
+                if (!compiled || formulas != previous) {
+                    size_t split = formulas.find(';');
+                    if (split == string::npos) {
+                        throw runtime_error("Expected \"f(x) ; f'(x)\".");
+                    }
+                    compiled = false;
+                    f = Expression(formulas.substr(0, split));
+                    fprime = Expression(formulas.substr(split + 1));
+                    previous = formulas;
+                    compiled = true;
+                }
+                RootResult result = newtonMethod(f, fprime, x0, epsilon, maxIterations);
+                if (fabs(f(result.root)) > epsilon) {
+                    throw runtime_error("Root not found within the maximum number of iterations.");
+                }
+                out.number(result.root).integer(result.iterations);
+                out.endRecord();
+            } catch (runtime_error &e) {
+                out.error(e.what());
+            }
+        }
+    } catch (runtime_error &e) {
+        out.flush();
+        cerr << e.what() << endl;
+        return -1;
     }
-    // Evaluate the expression using std::function
-    auto func = [expr](double x) {
-        return stod(expr);
-    };
-    return func(x);
+    return 0;
 }
 
-int main() {
+int main(int argc, char** argv) {
+    BatchOptions batch;
+    if (batchMode(argc, argv, batch)) {
+        return runBatchMode(batch, runBatch);
+    }
+
     double x0, epsilon;
     int maxIterations;
     string function_str, derivative_str;
 
     cout << "Enter the function f(x): ";
-    cin.ignore(); // to clear the buffer
     getline(cin, function_str);
     cout << "Enter the derivative f'(x): ";
     getline(cin, derivative_str);
@@ -40,24 +77,27 @@ int main() {
     cout << "Enter the maximum number of iterations: ";
     cin >> maxIterations;
 
-    double x = x0;
-    double fx = evaluate_expression(function_str, x);
-    int iteration = 0;
+    // Parse both formulas once, before the iteration starts
+    Expression f, fprime;
+    try {
+        f = Expression(function_str);
+        fprime = Expression(derivative_str);
+    } catch (runtime_error &e) {
+        cerr << e.what() << endl;
+        return -1;
+    }
 
-    while (fabs(fx) > epsilon && iteration < maxIterations) {
-        double fpx = evaluate_expression(derivative_str, x);
-        if (fabs(fpx) < 1e-10) {
-            cerr << "Error: Derivative is too small, division by zero risk." << endl;
-            return -1;
-        }
-        x = x - fx / fpx;
-        fx = evaluate_expression(function_str, x);
-        iteration++;
+    RootResult result;
+    try {
+        result = newtonMethod(f, fprime, x0, epsilon, maxIterations);
+    } catch (runtime_error &e) {
+        cerr << "Error: " << e.what() << endl;
+        return -1;
     }
 
-    if (fabs(fx) <= epsilon) {
-        cout << "Root found: x = " << setprecision(10) << x << endl;
-        cout << "Number of iterations: " << iteration << endl;
+    if (fabs(f(result.root)) <= epsilon) {
+        cout << "Root found: x = " << setprecision(10) << result.root << endl;
+        cout << "Number of iterations: " << result.iterations << endl;
     } else {
         cout << "Root not found within the maximum number of iterations." << endl;
     }
@@ -0,0 +1,306 @@
+#ifndef BATCH_IO_H
+#define BATCH_IO_H
+
+#include <cctype>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "solver_stats.h"
+
+// Bulk reader for the non-interactive batch mode of the programs.
+//
+// The input is a stream of whitespace-separated numbers and text lines.
+// It is read in large blocks and numbers are parsed in place with
+// std::from_chars, so there is no per-value stream extraction, locale
+// lookup or allocation. '#' starts a comment that runs to the end of the
+// line. Malformed input throws std::runtime_error with the line number.
+class RecordReader {
+public:
+    static const std::size_t BlockSize = 1 << 20;
+
+    // Read from `path`, or from standard input when path is "-"
+    explicit RecordReader(const std::string& path)
+        : in(&std::cin), buffer(BlockSize), begin(0), end(0), eof(false), line(1) {
+        if (path != "-") {
+            file.reset(new std::ifstream(path, std::ios::binary));
+            if (!*file) {
+                throw std::runtime_error("Cannot open " + path);
+            }
+            in = file.get();
+        }
+    }
+
+    // True once only whitespace and comments are left
+    bool atEnd() {
+        skipSpace();
+        return begin == end;
+    }
+
+    double number() {
+        double value;
+        parse(value);
+        return value;
+    }
+
+    long integer() {
+        long value;
+        parse(value);
+        return value;
+    }
+
+    // Read `count` numbers into values[0 .. count)
+    void numbers(double* values, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i) {
+            parse(values[i]);
+        }
+    }
+
+    // Text from the next non-blank character to the end of its line, without
+    // trailing spaces or comment (e.g. an equation after the numbers of a
+    // record, or on a line of its own); the next read starts on the
+    // following line
+    std::string textLine() {
+        skipSpace();
+        if (begin == end) {
+            fail("unexpected end of input");
+        }
+        std::string text;
+        for (;;) {
+            const char* start = buffer.data() + begin;
+            const char* stop = static_cast<const char*>(std::memchr(start, '\n', end - begin));
+            if (stop || !refill(true)) {
+                std::size_t length = stop ? stop - start : end - begin;
+                text.append(start, length);
+                begin += length + (stop ? 1 : 0);
+                line += stop ? 1 : 0;
+                break;
+            }
+        }
+        std::size_t comment = text.find('#');
+        if (comment != std::string::npos) {
+            text.erase(comment);
+        }
+        while (!text.empty() && std::isspace(static_cast<unsigned char>(text.back()))) {
+            text.pop_back();
+        }
+        return text;
+    }
+
+    long lineNumber() const { return line; }
+
+    // Report malformed input at the current line
+    [[noreturn]] void fail(const std::string& message) const {
+        throw std::runtime_error("Batch input line " + std::to_string(line) + ": " + message);
+    }
+
+private:
+    std::istream* in;
+    std::unique_ptr<std::ifstream> file;
+    std::vector<char> buffer;
+    std::size_t begin, end;
+    bool eof;
+    long line;
+
+    // Move the unread tail to the front and read the next block after it.
+    // With `grow`, the buffer is enlarged when the tail already fills it
+    // (a text line longer than one block).
+    bool refill(bool grow = false) {
+        if (eof) {
+            return false;
+        }
+        std::size_t left = end - begin;
+        std::memmove(buffer.data(), buffer.data() + begin, left);
+        begin = 0;
+        end = left;
+        if (grow && end == buffer.size()) {
+            buffer.resize(2 * buffer.size());
+        }
+        in->read(buffer.data() + end, buffer.size() - end);
+        std::size_t got = in->gcount();
+        end += got;
+        eof = got == 0 || !*in;
+        return got > 0;
+    }
+
+    void skipSpace() {
+        bool comment = false;
+        for (;;) {
+            while (begin < end) {
+                char ch = buffer[begin];
+                if (ch == '\n') {
+                    line++;
+                    comment = false;
+                } else if (ch == '#') {
+                    comment = true;
+                } else if (!comment && !std::isspace(static_cast<unsigned char>(ch))) {
+                    return;
+                }
+                begin++;
+            }
+            if (!refill()) {
+                return;
+            }
+        }
+    }
+
+    // A token is complete if a separator follows it inside the buffer;
+    // numbers are short, so refilling once is always enough
+    std::size_t tokenEnd() {
+        for (;;) {
+            std::size_t stop = begin;
+            while (stop < end && !std::isspace(static_cast<unsigned char>(buffer[stop])) && buffer[stop] != '#') {
+                stop++;
+            }
+            if (stop < end || eof || !refill()) {
+                return stop;
+            }
+        }
+    }
+
+    template <typename T>
+    void parse(T& value) {
+        skipSpace();
+        if (begin == end) {
+            fail("unexpected end of input");
+        }
+        std::size_t stop = tokenEnd();
+        const char* first = buffer.data() + begin;
+        const char* last = buffer.data() + stop;
+        if (*first == '+') {
+            first++;  // from_chars does not accept a leading plus sign
+        }
+        std::from_chars_result result = std::from_chars(first, last, value);
+        if (result.ec != std::errc() || result.ptr != last) {
+            fail("invalid number '" + std::string(buffer.data() + begin, stop - begin) + "'");
+        }
+        begin = stop;
+    }
+};
+
+// Buffered writer for batch results: numbers are formatted with
+// std::to_chars (shortest representation that reads back exactly) into one
+// buffer that is flushed in large blocks. Each record ends with a newline.
+class RecordWriter {
+public:
+    static const std::size_t FlushSize = 1 << 16;
+
+    explicit RecordWriter(std::ostream& stream) : out(stream), atLineStart(true) {
+        buffer.reserve(FlushSize + 64);
+    }
+
+    ~RecordWriter() {
+        flush();
+    }
+
+    RecordWriter& number(double value) {
+        separate();
+        char text[32];
+        std::to_chars_result result = std::to_chars(text, text + sizeof(text), value);
+        buffer.append(text, result.ptr);
+        return *this;
+    }
+
+    RecordWriter& integer(long value) {
+        separate();
+        char text[24];
+        std::to_chars_result result = std::to_chars(text, text + sizeof(text), value);
+        buffer.append(text, result.ptr);
+        return *this;
+    }
+
+    RecordWriter& text(const std::string& value) {
+        separate();
+        buffer += value;
+        return *this;
+    }
+
+    void endRecord() {
+        buffer += '\n';
+        atLineStart = true;
+        if (buffer.size() >= FlushSize) {
+            flush();
+        }
+    }
+
+    // A record that failed: "error <message>", so output lines stay aligned
+    // with input records
+    void error(const std::string& message) {
+        text("error").text(message);
+        endRecord();
+    }
+
+    void flush() {
+        out.write(buffer.data(), buffer.size());
+        out.flush();
+        buffer.clear();
+    }
+
+private:
+    std::ostream& out;
+    std::string buffer;
+    bool atLineStart;
+
+    void separate() {
+        if (!atLineStart) {
+            buffer += ' ';
+        }
+        atLineStart = false;
+    }
+};
+
+// Command line of the batch mode: `program --batch [file] [--stats out.json]`
+struct BatchOptions {
+    std::string input = "-";  // "-" for standard input
+    std::string stats;        // empty: no statistics
+};
+
+// True when the program was started with --batch; the input path and the
+// statistics file go into `options`
+inline bool batchMode(int argc, char** argv, BatchOptions& options) {
+    if (argc < 2 || std::string(argv[1]) != "--batch") {
+        return false;
+    }
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--stats" && i + 1 < argc) {
+            options.stats = argv[++i];
+        } else {
+            options.input = arg;
+        }
+    }
+    return true;
+}
+
+// Run the batch loop `run(input)`. With --stats the solver statistics of
+// the whole batch are collected and written to the given file as JSON.
+// Without --stats no collector is installed, so the solvers skip the clock
+// and nothing is kept per solve.
+template <typename Run>
+int runBatchMode(const BatchOptions& options, Run run) {
+    if (options.stats.empty()) {
+        return run(options.input);
+    }
+    StatsCollector stats;
+    int status;
+    {
+        StatsCollection collecting(stats);
+        status = run(options.input);
+    }
+    std::ofstream out(options.stats);
+    stats.writeJson(out);
+    if (!out) {
+        std::cerr << "Cannot write " << options.stats << std::endl;
+        return -1;
+    }
+    return status;
+}
+
+#endif
@@ -0,0 +1,499 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <functional>
+#include <memory>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "cubic_roots.h"
+#include "dense_matrix.h"
+#include "eigen.h"
+#include "expression.h"
+#include "interpolation.h"
+#include "iteration_observer.h"
+#include "linear_systems.h"
+#include "lu.h"
+#include "nonlinear_systems.h"
+#include "ode.h"
+#include "root_finding.h"
+#include "sparse_matrix.h"
+
+using namespace std;
+
+// Micro- and macro-benchmarks of the numerics kernels.
+//
+//   bench [--list] [--filter text] [--sizes n1,n2,...] [--max-size n]
+//         [--repeat r] [--out file]
+//
+// Every case is run for each of its problem sizes: inputs are generated
+// from a fixed seed, the kernel runs once to warm up and then `repeat`
+// timed runs follow. The results go out as one JSON document (to stdout
+// unless --out is given); progress is printed to stderr.
+//
+// What the size means depends on the case: the matrix order for dense
+// solves, the grid side for the sparse solvers, the number of problems for
+// batched kernels. --sizes and --max-size apply to every selected case.
+
+// Timed body of one case at one size. It returns a checksum of the result
+// so the work cannot be optimized away; `items` is the work per run used
+// for the throughput figure.
+struct Run {
+    function<double()> body;
+    double items;
+    string unit;
+};
+
+struct Case {
+    string name;
+    string kind;  // "micro" (single kernel) or "macro" (whole solve)
+    vector<long> sizes;
+    function<Run(long n)> prepare;
+};
+
+// Deterministic uniform numbers in [-1, 1)
+class Random {
+public:
+    explicit Random(unsigned long long seed = 0x9E3779B97F4A7C15ULL) : state(seed) {}
+
+    double operator()() {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<double>(state >> 11) / 9007199254740992.0 * 2.0 - 1.0;
+    }
+
+private:
+    unsigned long long state;
+};
+
+// Random matrix made strictly diagonally dominant (nonsingular, well conditioned)
+DenseMatrix dominantMatrix(int n) {
+    Random random;
+    DenseMatrix A(n, n);
+    for (int i = 0; i < n; ++i) {
+        double* row = A.row(i);
+        for (int j = 0; j < n; ++j) {
+            row[j] = random();
+        }
+        row[i] = n;
+    }
+    return A;
+}
+
+DenseMatrix symmetricMatrix(int n) {
+    Random random;
+    DenseMatrix A(n, n);
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j <= i; ++j) {
+            A(i, j) = A(j, i) = random();
+        }
+    }
+    return A;
+}
+
+// 5-point Laplacian on an m x m grid
+SparseMatrix poisson2D(int m) {
+    vector<int> r, c;
+    vector<double> v;
+    auto add = [&](int i, int j, double value) {
+        r.push_back(i);
+        c.push_back(j);
+        v.push_back(value);
+    };
+    for (int y = 0; y < m; ++y) {
+        for (int x = 0; x < m; ++x) {
+            int i = y * m + x;
+            add(i, i, 4.0);
+            if (x > 0) add(i, i - 1, -1.0);
+            if (x + 1 < m) add(i, i + 1, -1.0);
+            if (y > 0) add(i, i - m, -1.0);
+            if (y + 1 < m) add(i, i + m, -1.0);
+        }
+    }
+    int n = m * m;
+    return SparseMatrix(n, n, move(r), move(c), move(v));
+}
+
+double sum(const vector<double>& v) {
+    double s = 0.0;
+    for (double value : v) {
+        s += value;
+    }
+    return s;
+}
+
+const vector<long> DenseSizes = {100, 250, 500, 1000, 2000, 4000, 8000};
+const vector<long> GridSizes = {32, 64, 128, 256, 512};
+const vector<long> BatchSizes = {10000, 100000, 1000000, 10000000};
+
+// Fixed iteration count of the iterative solvers: tolerance 0 never stops early
+const int FixedSweeps = 100;
+
+typedef int (*StationarySolver)(const SparseMatrix&, const vector<double>&, vector<double>&, int, double, IterationObserver&);
+
+Case stationaryCase(const string& name, StationarySolver solver) {
+    return {name, "macro", GridSizes, [solver](long m) {
+        auto A = make_shared<SparseMatrix>(poisson2D(m));
+        auto b = make_shared<vector<double>>(A->rows(), 1.0);
+        auto x = make_shared<vector<double>>(A->rows());
+        return Run{[=]() {
+            IterationObserver off;
+            fill(x->begin(), x->end(), 0.0);
+            solver(*A, *b, *x, FixedSweeps, 0.0, off);
+            return sum(*x);
+        }, static_cast<double>(FixedSweeps) * A->nonZeros(), "nonzeros"};
+    }};
+}
+
+int jacobiSolver(const SparseMatrix& A, const vector<double>& b, vector<double>& x, int maxIterations, double tolerance, IterationObserver& observer) {
+    return jacobi(A, b, x, maxIterations, tolerance, observer);
+}
+
+int sorSolver(const SparseMatrix& A, const vector<double>& b, vector<double>& x, int maxIterations, double tolerance, IterationObserver& observer) {
+    return sor(A, b, x, 1.9, maxIterations, tolerance, observer);
+}
+
+int multicolorSorSolver(const SparseMatrix& A, const vector<double>& b, vector<double>& x, int maxIterations, double tolerance, IterationObserver& observer) {
+    return multicolorSor(A, b, x, 1.9, maxIterations, tolerance, observer);
+}
+
+vector<Case> allCases() {
+    vector<Case> cases;
+
+    // Dense linear algebra
+    cases.push_back({"gauss_elimination", "macro", DenseSizes, [](long n) {
+        auto A = make_shared<DenseMatrix>(dominantMatrix(n));
+        auto b = make_shared<vector<double>>(n, 1.0);
+        double flops = 2.0 / 3.0 * n * n * n;
+        return Run{[=]() { return sum(gaussElimination(*A, *b)); }, flops, "flops"};
+    }});
+    cases.push_back({"lu_solve", "micro", DenseSizes, [](long n) {
+        auto lu = make_shared<LUFactorization>(dominantMatrix(n));
+        auto b = make_shared<vector<double>>(n);
+        return Run{[=]() {
+            fill(b->begin(), b->end(), 1.0);
+            lu->solveInPlace(*b);
+            return sum(*b);
+        }, 2.0 * n * n, "flops"};
+    }});
+    cases.push_back({"dense_matvec", "micro", DenseSizes, [](long n) {
+        auto A = make_shared<DenseMatrix>(dominantMatrix(n));
+        auto x = make_shared<vector<double>>(n, 1.0);
+        auto y = make_shared<vector<double>>(n);
+        return Run{[=]() {
+            matrixVectorMultiply(*A, *x, *y);
+            return sum(*y);
+        }, 2.0 * n * n, "flops"};
+    }});
+
+    // Sparse iterative solvers
+    cases.push_back(stationaryCase("jacobi", jacobiSolver));
+    cases.push_back(stationaryCase("sor", sorSolver));
+    cases.push_back(stationaryCase("multicolor_sor", multicolorSorSolver));
+
+    // Eigenvalues
+    cases.push_back({"power_iteration", "macro", {100, 250, 500, 1000, 2000, 4000}, [](long n) {
+        auto A = make_shared<DenseMatrix>(symmetricMatrix(n));
+        const int iterations = 50;
+        return Run{[=]() {
+            vector<double> v(n, 1.0);
+            return powerIteration(*A, v, 0.0, iterations, false);
+        }, 2.0 * iterations * n * n, "flops"};
+    }});
+    cases.push_back({"lanczos", "macro", {100, 250, 500, 1000, 2000}, [](long n) {
+        auto A = make_shared<DenseMatrix>(symmetricMatrix(n));
+        return Run{[=]() {
+            EigenPairs pairs = lanczos(denseOperator(*A), n, 4, 1e-8, 100);
+            return sum(pairs.values);
+        }, 1.0, "solves"};
+    }});
+
+    // Root finding
+    cases.push_back({"cubic_bisection_batch", "micro", BatchSizes, [](long n) {
+        auto coefficients = make_shared<vector<double>>(4 * n);
+        Random random;
+        double* c = coefficients->data();
+        for (long i = 0; i < n; ++i) {
+            double r = random();
+            c[i] = 1.0;
+            c[n + i] = 4.0 * random();
+            c[2 * n + i] = 4.0 * random();
+            c[3 * n + i] = -cubic(1.0, c[n + i], c[2 * n + i], 0.0, r);
+        }
+        auto lower = make_shared<vector<double>>(n, -1.0);
+        auto upper = make_shared<vector<double>>(n, 1.0);
+        auto roots = make_shared<vector<double>>(n);
+        return Run{[=]() {
+            const double* c = coefficients->data();
+            return static_cast<double>(bisectionBatch(c, c + n, c + 2 * n, c + 3 * n, lower->data(), upper->data(),
+                                                      roots->data(), n, 1e-12));
+        }, static_cast<double>(n), "roots"};
+    }});
+    cases.push_back({"cubic_roots", "micro", {10000, 100000, 1000000}, [](long n) {
+        auto coefficients = make_shared<vector<double>>(3 * n);
+        Random random;
+        for (double& value : *coefficients) {
+            value = 4.0 * random();
+        }
+        return Run{[=]() {
+            const double* c = coefficients->data();
+            double total = 0.0;
+            for (long i = 0; i < n; ++i) {
+                total += cubicRoots(1.0, c[i], c[n + i], c[2 * n + i], -10.0, 10.0).size();
+            }
+            return total;
+        }, static_cast<double>(n), "cubics"};
+    }});
+    cases.push_back({"brent", "micro", {1000, 10000, 100000}, [](long n) {
+        auto expr = make_shared<Expression>("exp(x) - 10");
+        return Run{[=]() {
+            double total = 0.0;
+            for (long i = 0; i < n; ++i) {
+                total += brentMethod(*expr, 0.0, 5.0, 1e-12, 100).root;
+            }
+            return total;
+        }, static_cast<double>(n), "solves"};
+    }});
+    cases.push_back({"broyden", "macro", {10, 50, 100, 200, 400}, [](long n) {
+        // Discrete Bratu problem -u'' = exp(u) on a uniform grid
+        double h2 = 1.0 / ((n + 1.0) * (n + 1.0));
+        ResidualFunction F = [n, h2](const vector<double>& u, vector<double>& r) {
+            for (long i = 0; i < n; ++i) {
+                double left = i > 0 ? u[i - 1] : 0.0;
+                double right = i + 1 < n ? u[i + 1] : 0.0;
+                r[i] = (2 * u[i] - left - right) - h2 * exp(u[i]);
+            }
+        };
+        return Run{[=]() {
+            SolverStats stats;
+            return sum(broyden(F, JacobianFunction(), vector<double>(n, 0.0), 1e-10, 100, stats));
+        }, 1.0, "solves"};
+    }});
+
+    // Interpolation
+    cases.push_back({"newton_forward_batch", "micro", BatchSizes, [](long n) {
+        const int points = 16;
+        vector<double> x(points), y(points);
+        for (int i = 0; i < points; ++i) {
+            x[i] = i;
+            y[i] = sin(0.3 * i);
+        }
+        vector<double> tail;
+        vector<double> leading = forwardDifferences(y, points, &tail);
+        auto p = make_shared<NewtonForward>(buildNewtonForward(x, leading, tail, points));
+        auto values = make_shared<vector<double>>(n);
+        auto results = make_shared<vector<double>>(n);
+        Random random;
+        for (double& value : *values) {
+            value = 7.5 + 7.5 * random();
+        }
+        return Run{[=]() {
+            newtonForwardInterpolationBatch(*p, values->data(), results->data(), n);
+            return sum(*results);
+        }, static_cast<double>(n), "queries"};
+    }});
+    cases.push_back({"interpolation_index", "micro", {1000, 10000, 100000, 1000000}, [](long n) {
+        vector<double> x(n), y(n);
+        Random random;
+        double position = 0.0;
+        for (long i = 0; i < n; ++i) {
+            position += 1.0 + 0.5 * random();
+            x[i] = position;
+            y[i] = sin(1e-3 * position);
+        }
+        auto index = make_shared<InterpolationIndex>(x, y, 3);
+        const long queries = 1000000;
+        auto values = make_shared<vector<double>>(queries);
+        auto results = make_shared<vector<double>>(queries);
+        for (double& value : *values) {
+            value = position * (0.5 + 0.5 * random());
+        }
+        return Run{[=]() {
+            index->evaluateBatch(values->data(), results->data(), queries);
+            return sum(*results);
+        }, static_cast<double>(queries), "queries"};
+    }});
+
+    // ODEs
+    // The same RK4 run with the right-hand side inlined and through the
+    // type-erased RhsFunction wrapper, to show the cost of the dispatch
+    cases.push_back({"rk4_inline", "micro", {10000, 100000, 1000000, 10000000}, [](long n) {
+        return Run{[=]() { return rungeKutta4(0.0, 4.0, 1.0 / n, n, ExampleRhs()); },
+                   static_cast<double>(n), "steps"};
+    }});
+    cases.push_back({"rk4_function", "micro", {10000, 100000, 1000000, 10000000}, [](long n) {
+        auto f = make_shared<RhsFunction>(ExampleRhs());
+        return Run{[=]() { return rungeKutta4(0.0, 4.0, 1.0 / n, n, *f); },
+                   static_cast<double>(n), "steps"};
+    }});
+    cases.push_back({"rk4_batch", "macro", {1000, 10000, 100000, 1000000}, [](long n) {
+        auto x = make_shared<vector<double>>(n);
+        auto y = make_shared<vector<double>>(n);
+        const int steps = 100;
+        return Run{[=]() {
+            for (long i = 0; i < n; ++i) {
+                (*x)[i] = 0.0;
+                (*y)[i] = 4.0 + 1e-3 * static_cast<double>(i) / n;
+            }
+            rungeKutta4Batch(x->data(), y->data(), n, 0.01, steps, ExampleRhs());
+            return sum(*y);
+        }, static_cast<double>(n) * steps, "steps"};
+    }});
+    cases.push_back({"dormand_prince", "micro", {4, 6, 8, 10, 12}, [](long n) {
+        // Size is the number of correct digits asked for: tolerance 10^-n
+        double tolerance = pow(10.0, -static_cast<double>(n));
+        return Run{[=]() {
+            StepStats stats;
+            return dormandPrince(0.0, 4.0, 10.0, tolerance, tolerance, ExampleRhs(), stats);
+        }, 1.0, "solves"};
+    }});
+
+    return cases;
+}
+
+// Escape a string for a JSON string literal
+string jsonString(const string& text) {
+    string out = "\"";
+    for (char ch : text) {
+        if (ch == '"' || ch == '\\') {
+            out += '\\';
+        }
+        out += ch;
+    }
+    return out + "\"";
+}
+
+string jsonNumber(double value) {
+    if (!isfinite(value)) {
+        return "null";
+    }
+    ostringstream out;
+    out.precision(10);
+    out << value;
+    return out.str();
+}
+
+vector<long> parseSizes(const string& list) {
+    vector<long> sizes;
+    stringstream in(list);
+    string item;
+    while (getline(in, item, ',')) {
+        sizes.push_back(stol(item));
+    }
+    return sizes;
+}
+
+int main(int argc, char** argv) {
+    string filter, outPath;
+    vector<long> sizes;
+    long maxSize = 0;
+    int repeat = 5;
+    bool list = false;
+
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        auto value = [&]() -> string {
+            if (i + 1 >= argc) {
+                throw runtime_error("Missing value for " + arg);
+            }
+            return argv[++i];
+        };
+        try {
+            if (arg == "--list") {
+                list = true;
+            } else if (arg == "--filter") {
+                filter = value();
+            } else if (arg == "--sizes") {
+                sizes = parseSizes(value());
+            } else if (arg == "--max-size") {
+                maxSize = stol(value());
+            } else if (arg == "--repeat") {
+                repeat = max(1, stoi(value()));
+            } else if (arg == "--out") {
+                outPath = value();
+            } else {
+                throw runtime_error("Unknown argument " + arg);
+            }
+        } catch (exception& e) {
+            cerr << e.what() << endl;
+            cerr << "usage: bench [--list] [--filter text] [--sizes n1,n2,...] [--max-size n] [--repeat r] [--out file]" << endl;
+            return -1;
+        }
+    }
+
+    vector<Case> cases = allCases();
+    if (list) {
+        for (const Case& c : cases) {
+            cout << c.name << " (" << c.kind << ")" << endl;
+        }
+        return 0;
+    }
+
+    int threads = 1;
+#ifdef _OPENMP
+    threads = omp_get_max_threads();
+#endif
+
+    ostringstream json;
+    json << "{\n  \"threads\": " << threads << ",\n  \"repeat\": " << repeat << ",\n  \"results\": [";
+    bool first = true;
+    for (const Case& c : cases) {
+        if (!filter.empty() && c.name.find(filter) == string::npos) {
+            continue;
+        }
+        for (long n : sizes.empty() ? c.sizes : sizes) {
+            if (maxSize > 0 && n > maxSize) {
+                continue;
+            }
+            cerr << c.name << " n = " << n << " ... " << flush;
+            Run run = c.prepare(n);
+            double checksum = run.body();  // warm-up
+
+            vector<double> seconds(repeat);
+            for (int r = 0; r < repeat; ++r) {
+                auto begin = chrono::steady_clock::now();
+                checksum = run.body();
+                seconds[r] = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+            }
+            vector<double> sorted = seconds;
+            sort(sorted.begin(), sorted.end());
+            double median = repeat % 2 ? sorted[repeat / 2] : (sorted[repeat / 2 - 1] + sorted[repeat / 2]) / 2;
+            double mean = sum(seconds) / repeat;
+            cerr << median << " s" << endl;
+
+            json << (first ? "\n" : ",\n") << "    {\"name\": " << jsonString(c.name)
+                 << ", \"kind\": " << jsonString(c.kind)
+                 << ", \"size\": " << n
+                 << ", \"min_seconds\": " << jsonNumber(sorted.front())
+                 << ", \"median_seconds\": " << jsonNumber(median)
+                 << ", \"mean_seconds\": " << jsonNumber(mean)
+                 << ", \"max_seconds\": " << jsonNumber(sorted.back())
+                 << ", \"items\": " << jsonNumber(run.items)
+                 << ", \"unit\": " << jsonString(run.unit)
+                 << ", \"items_per_second\": " << jsonNumber(run.items / median)
+                 << ", \"checksum\": " << jsonNumber(checksum) << "}";
+            first = false;
+        }
+    }
+    json << "\n  ]\n}\n";
+
+    if (outPath.empty()) {
+        cout << json.str();
+    } else {
+        ofstream out(outPath);
+        if (!out) {
+            cerr << "Cannot open " << outPath << endl;
+            return -1;
+        }
+        out << json.str();
+    }
+    return 0;
+}
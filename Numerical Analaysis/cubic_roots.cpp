@@ -0,0 +1,248 @@
+#include <iostream>
+#include <cmath>
+#include <cfloat>
+#include <algorithm>
+
+#include "cubic_roots.h"
+#include "solver_stats.h"
+
+using namespace std;
+
+// Function to check if the function has a root in the interval (a, b)
+bool hasRoot(double a, double b, double c, double d, double lowerBound, double upperBound) {
+    return cubic(a, b, c, d, lowerBound) * cubic(a, b, c, d, upperBound) < 0;
+}
+
+// Bisection method to find the root
+double bisection(double a, double b, double c, double d, double lowerBound, double upperBound, double epsilon) {
+    if (!hasRoot(a, b, c, d, lowerBound, upperBound)) {
+        cerr << "The function does not have a root in the given interval." << endl;
+        return NAN;
+    }
+
+    SolveTimer timer("cubic_bisection");
+    double left = lowerBound;
+    double right = upperBound;
+    double fLeft = cubic(a, b, c, d, left);
+    double middle;
+    long iterations = 0;
+    while ((right - left) / 2 > epsilon) {
+        middle = (left + right) / 2;
+        double fMiddle = cubic(a, b, c, d, middle);
+        iterations++;
+        if (fMiddle == 0) {
+            timer.finish(iterations, iterations + 3, 0.0);
+            return middle;
+        } else if (fMiddle * fLeft < 0) {
+            right = middle;
+        } else {
+            left = middle;
+            fLeft = fMiddle;
+        }
+    }
+
+    // hasRoot evaluated both ends, then one evaluation per step
+    timer.finish(iterations, iterations + 3, fabs(fLeft));
+    return (left + right) / 2;
+}
+
+// Lanes per chunk and the cap on the number of steps a chunk may run
+const size_t BatchChunk = 512;
+const int MaxBisectionSteps = 200;
+
+// One bisection step on every lane of a chunk. A lane whose bracket is
+// already within its tolerance is left as it is.
+inline void bisectionStep(const double* A, const double* B, const double* C, const double* D,
+                          double* left, double* right, double* fLeft, const double* tolerance, size_t lanes) {
+    #pragma omp simd
+    for (size_t i = 0; i < lanes; ++i) {
+        double middle = (left[i] + right[i]) / 2;
+        double fMiddle = cubic(A[i], B[i], C[i], D[i], middle);
+        bool open = !((right[i] - left[i]) / 2 <= tolerance[i]);  // NaN tolerance: open
+        bool goLeft = signbit(fMiddle) != signbit(fLeft[i]);
+        right[i] = open && goLeft ? middle : right[i];
+        left[i] = open && !goLeft ? middle : left[i];
+        fLeft[i] = open && !goLeft ? fMiddle : fLeft[i];
+    }
+}
+
+// Shared by both overloads: lane i uses the tolerance epsilon[i * stride]
+static size_t bisectLanes(const double* a, const double* b, const double* c, const double* d,
+                          const double* lower, const double* upper, double* roots, size_t count,
+                          const double* epsilon, size_t stride) {
+    SolveTimer timer("cubic_bisection_batch");
+    size_t found = 0;
+    long iterations = 0, evaluations = 0;
+    #pragma omp parallel for schedule(dynamic) reduction(+:found, iterations, evaluations)
+    for (size_t start = 0; start < count; start += BatchChunk) {
+        size_t lanes = min(BatchChunk, count - start);
+        const double *A = a + start, *B = b + start, *C = c + start, *D = d + start;
+        double left[BatchChunk], right[BatchChunk], fLeft[BatchChunk], tolerance[BatchChunk];
+        bool bracket[BatchChunk];
+
+        // Steps needed by the lane that needs the most; a tolerance that is
+        // not positive (or NaN) gives no finite count and runs to the cap
+        double steps = 0.0;
+        for (size_t i = 0; i < lanes; ++i) {
+            left[i] = lower[start + i];
+            right[i] = upper[start + i];
+            tolerance[i] = epsilon[(start + i) * stride];
+            fLeft[i] = cubic(A[i], B[i], C[i], D[i], left[i]);
+            bracket[i] = fLeft[i] * cubic(A[i], B[i], C[i], D[i], right[i]) < 0;
+            if (bracket[i] && !((right[i] - left[i]) / 2 <= tolerance[i])) {
+                double need = ceil(log2((right[i] - left[i]) / (2 * tolerance[i])));
+                steps = need < MaxBisectionSteps ? max(steps, need) : MaxBisectionSteps;
+            }
+        }
+
+        int step = 0;
+        for (; step < MaxBisectionSteps; ++step) {
+            if (step >= steps) {
+                // Rounding in the step estimate: finish any lane still open
+                bool open = false;
+                for (size_t i = 0; i < lanes && !open; ++i) {
+                    open = bracket[i] && !((right[i] - left[i]) / 2 <= tolerance[i]);
+                }
+                if (!open) {
+                    break;
+                }
+            }
+            bisectionStep(A, B, C, D, left, right, fLeft, tolerance, lanes);
+        }
+
+        for (size_t i = 0; i < lanes; ++i) {
+            roots[start + i] = bracket[i] ? (left[i] + right[i]) / 2 : NAN;
+            found += bracket[i];
+        }
+        iterations += step;
+        evaluations += static_cast<long>(step + 2) * lanes;
+    }
+    // Iterations are the bisection steps summed over the chunks
+    timer.finish(iterations, evaluations, NAN);
+    return found;
+}
+
+size_t bisectionBatch(const double* a, const double* b, const double* c, const double* d,
+                      const double* lower, const double* upper, double* roots, size_t count, double epsilon) {
+    return bisectLanes(a, b, c, d, lower, upper, roots, count, &epsilon, 0);
+}
+
+size_t bisectionBatch(const double* a, const double* b, const double* c, const double* d,
+                      const double* lower, const double* upper, double* roots, size_t count, const double* epsilon) {
+    return bisectLanes(a, b, c, d, lower, upper, roots, count, epsilon, 1);
+}
+
+double polishRoot(double a, double b, double c, double d, double x, int steps) {
+    double fx = cubic(a, b, c, d, x);
+    for (int i = 0; i < steps; ++i) {
+        double slope = cubicDerivative(a, b, c, x);
+        if (slope == 0) {
+            break;
+        }
+        double next = x - fx / slope;
+        double fNext = cubic(a, b, c, d, next);
+        if (fabs(fNext) >= fabs(fx)) {
+            break;  // No progress: near a multiple root the step can overshoot
+        }
+        x = next;
+        fx = fNext;
+    }
+    return x;
+}
+
+vector<double> cubicRoots(double a, double b, double c, double d, double lowerBound, double upperBound) {
+    vector<double> candidates;
+    if (a != 0) {
+        double shift = b / (3 * a);
+        double p = (3 * a * c - b * b) / (3 * a * a);
+        double q = (2 * b * b * b - 9 * a * b * c + 27 * a * a * d) / (27 * a * a * a);
+        double discriminant = q * q / 4 + p * p * p / 27;
+        if (p == 0 && q == 0) {
+            candidates.push_back(-shift);
+        } else if (discriminant < 0) {
+            double radius = 2 * sqrt(-p / 3);
+            double cosine = max(-1.0, min(1.0, 3 * q / (p * radius)));
+            double angle = acos(cosine) / 3;
+            for (int k = 0; k < 3; ++k) {
+                candidates.push_back(radius * cos(angle - 2 * M_PI * k / 3) - shift);
+            }
+        } else {
+            double s = sqrt(discriminant);
+            candidates.push_back(cbrt(-q / 2 + s) + cbrt(-q / 2 - s) - shift);
+        }
+    } else if (b != 0) {
+        double discriminant = c * c - 4 * b * d;
+        if (discriminant >= 0) {
+            // Stable form: avoid subtracting nearly equal numbers
+            double t = -(c + copysign(sqrt(discriminant), c)) / 2;
+            candidates.push_back(t / b);
+            if (t != 0) {
+                candidates.push_back(d / t);
+            }
+        }
+    } else if (c != 0) {
+        candidates.push_back(-d / c);
+    }
+
+    // Double roots. The closed forms only see one when the discriminant is
+    // exactly zero, which rounding almost never leaves it at. A double root
+    // is a root of f' where f vanishes, and as a simple root of the
+    // quadratic f' it comes out to full precision. Candidates that the
+    // closed forms put next to it are the same root and are dropped before
+    // polishing, since Newton steps are unreliable where f' vanishes.
+    vector<double> doubles;
+    double qa = 3 * a, qb = 2 * b, qc = c;  // f'(x) = qa x^2 + qb x + qc
+    vector<double> critical;
+    if (qa != 0) {
+        double discriminant = qb * qb - 4 * qa * qc;
+        if (discriminant >= 0) {
+            double t = -(qb + copysign(sqrt(discriminant), qb)) / 2;
+            critical.push_back(t / qa);
+            if (t != 0) {
+                critical.push_back(qc / t);
+            }
+        }
+    } else if (qb != 0) {
+        critical.push_back(-qc / qb);
+    }
+    // The closed forms lose about half the digits at a double root, relative
+    // to the size of the critical points
+    double spread = 0.0;
+    for (double x : critical) {
+        spread += 16 * sqrt(DBL_EPSILON) * fabs(x);
+    }
+    for (double x : critical) {
+        // |f| within the rounding error of evaluating it counts as zero
+        double size = ((fabs(a) * fabs(x) + fabs(b)) * fabs(x) + fabs(c)) * fabs(x) + fabs(d);
+        double tolerance = 32 * DBL_EPSILON * size;
+        if (fabs(cubic(a, b, c, d, x)) > tolerance) {
+            continue;
+        }
+        // Near the double root f ~ f''/2 (t - x)^2, so roots the closed
+        // forms find for it lie within sqrt(2 tolerance / |f''|)
+        double curvature = fabs(6 * a * x + 2 * b);
+        double radius = curvature > 0 ? 2 * sqrt(2 * tolerance / curvature) : INFINITY;
+        radius = max(radius, spread);
+        candidates.erase(remove_if(candidates.begin(), candidates.end(), [x, radius](double r) {
+            return fabs(r - x) <= radius;
+        }), candidates.end());
+        doubles.push_back(x);
+    }
+    for (double& x : candidates) {
+        x = polishRoot(a, b, c, d, x);
+    }
+    candidates.insert(candidates.end(), doubles.begin(), doubles.end());
+
+    vector<double> roots;
+    for (double x : candidates) {
+        if (x >= lowerBound && x <= upperBound) {
+            roots.push_back(x);
+        }
+    }
+    sort(roots.begin(), roots.end());
+    double scale = max(1.0, max(fabs(lowerBound), fabs(upperBound)));
+    roots.erase(unique(roots.begin(), roots.end(), [scale](double x, double y) {
+        return y - x <= 1e-12 * scale;
+    }), roots.end());
+    return roots;
+}
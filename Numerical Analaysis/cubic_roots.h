@@ -0,0 +1,115 @@
+#ifndef CUBIC_ROOTS_H
+#define CUBIC_ROOTS_H
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+// Roots of cubics ax^3 + bx^2 + cx + d: scalar and batched bisection, the
+// closed-form all-roots solver, and a sign-change scan for general functions.
+
+// Evaluate ax^3 + bx^2 + cx + d (Horner's rule: three multiply-adds, no pow calls)
+inline double cubic(double a, double b, double c, double d, double x) {
+    return ((a * x + b) * x + c) * x + d;
+}
+
+// Derivative 3ax^2 + 2bx + c
+inline double cubicDerivative(double a, double b, double c, double x) {
+    return (3 * a * x + 2 * b) * x + c;
+}
+
+// True if the cubic changes sign between lowerBound and upperBound
+bool hasRoot(double a, double b, double c, double d, double lowerBound, double upperBound);
+
+// Bisection method to find the root; NaN if the ends do not bracket one
+double bisection(double a, double b, double c, double d, double lowerBound, double upperBound, double epsilon);
+
+// Batched bisection for many cubics a[i] x^3 + b[i] x^2 + c[i] x + d[i]
+// on their own intervals [lower[i], upper[i]].
+//
+// Lanes are processed in fixed-size chunks; chunks are spread across
+// threads and every bisection step runs over the lanes of a chunk as one
+// SIMD loop. The side is chosen by comparing sign bits and lanes are masked
+// rather than branched on, so the step vectorizes without fast-math.
+// A chunk runs as many steps as its slowest lane needs; a lane stops
+// moving once its bracket is within its own tolerance, so its result does
+// not depend on the other lanes. Lanes without a sign change get NaN. A
+// tolerance that is not positive halves up to an internal cap of steps.
+// Returns the number of roots found.
+std::size_t bisectionBatch(const double* a, const double* b, const double* c, const double* d,
+                           const double* lower, const double* upper, double* roots, std::size_t count, double epsilon);
+
+// Same with a tolerance per lane, epsilon[i]
+std::size_t bisectionBatch(const double* a, const double* b, const double* c, const double* d,
+                           const double* lower, const double* upper, double* roots, std::size_t count,
+                           const double* epsilon);
+
+// A couple of Newton steps on the original coefficients clean up the
+// cancellation left by the closed-form expressions; a step that does not
+// reduce |f| is not taken
+double polishRoot(double a, double b, double c, double d, double x, int steps = 2);
+
+// Every real root of ax^3 + bx^2 + cx + d in [lowerBound, upperBound],
+// sorted and with repeated roots reported once.
+//
+// Three real roots come from the trigonometric form of the depressed cubic
+// t^3 + pt + q, one real root from Cardano's formula; a == 0 falls back to
+// the quadratic and linear cases. No bracket or sign change is needed, so
+// double roots and intervals holding two or three roots are handled. The
+// zero polynomial has no isolated roots and returns an empty list.
+std::vector<double> cubicRoots(double a, double b, double c, double d, double lowerBound, double upperBound);
+
+// Every sign change of a general function g on [lowerBound, upperBound].
+//
+// The interval is cut into `subintervals` pieces; g is sampled on the grid
+// and each bracketing piece is bisected down to epsilon, both in parallel.
+// Results come out in increasing order regardless of the thread count.
+// Roots without a sign change (even multiplicity) or two roots inside one
+// piece are missed, so choose the grid finer than the root spacing.
+template <typename Function>
+std::vector<double> scanRoots(Function g, double lowerBound, double upperBound, std::size_t subintervals, double epsilon) {
+    double h = (upperBound - lowerBound) / subintervals;
+    std::vector<double> values(subintervals + 1);
+    #pragma omp parallel for schedule(static)
+    for (std::size_t i = 0; i <= subintervals; ++i) {
+        values[i] = g(i == subintervals ? upperBound : lowerBound + i * h);
+    }
+
+    std::vector<double> found(subintervals + 1, NAN);
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (std::size_t i = 0; i <= subintervals; ++i) {
+        double left = lowerBound + i * h;
+        if (values[i] == 0) {
+            found[i] = left;
+            continue;
+        }
+        if (i == subintervals || values[i + 1] == 0 || std::signbit(values[i]) == std::signbit(values[i + 1])) {
+            continue;
+        }
+        double right = i + 1 == subintervals ? upperBound : left + h;
+        double fLeft = values[i];
+        while ((right - left) / 2 > epsilon) {
+            double middle = (left + right) / 2;
+            double fMiddle = g(middle);
+            if (fMiddle == 0) {
+                left = right = middle;
+            } else if (std::signbit(fMiddle) != std::signbit(fLeft)) {
+                right = middle;
+            } else {
+                left = middle;
+                fLeft = fMiddle;
+            }
+        }
+        found[i] = (left + right) / 2;
+    }
+
+    std::vector<double> roots;
+    for (double x : found) {
+        if (!std::isnan(x)) {
+            roots.push_back(x);
+        }
+    }
+    return roots;
+}
+
+#endif
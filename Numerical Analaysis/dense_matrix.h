@@ -0,0 +1,40 @@
+#ifndef DENSE_MATRIX_H
+#define DENSE_MATRIX_H
+
+#include <cstddef>
+#include <vector>
+
+// Dense matrix stored as one contiguous row-major block
+class DenseMatrix {
+public:
+    DenseMatrix() : nRows(0), nCols(0) {}
+
+    DenseMatrix(int rows, int cols, double value = 0.0)
+        : nRows(rows), nCols(cols), values(static_cast<size_t>(rows) * cols, value) {}
+
+    static DenseMatrix identity(int n) {
+        DenseMatrix I(n, n);
+        for (int i = 0; i < n; ++i) {
+            I(i, i) = 1.0;
+        }
+        return I;
+    }
+
+    int rows() const { return nRows; }
+    int cols() const { return nCols; }
+
+    double& operator()(int i, int j) { return values[static_cast<size_t>(i) * nCols + j]; }
+    double operator()(int i, int j) const { return values[static_cast<size_t>(i) * nCols + j]; }
+
+    double* row(int i) { return values.data() + static_cast<size_t>(i) * nCols; }
+    const double* row(int i) const { return values.data() + static_cast<size_t>(i) * nCols; }
+
+    double* data() { return values.data(); }
+    const double* data() const { return values.data(); }
+
+private:
+    int nRows, nCols;
+    std::vector<double> values;
+};
+
+#endif
@@ -0,0 +1,111 @@
+#ifndef DUAL_H
+#define DUAL_H
+
+#include <cmath>
+
+// Dual number for forward-mode automatic differentiation.
+// Carries a value and its partial derivatives with respect to N seeded
+// directions, so one evaluation gives f and N columns of its gradient
+// exactly (no step size, no cancellation).
+//
+//   Dual<2> x(1.5, 0), y(0.5, 1);   // seed d/dx and d/dy
+//   Dual<2> f = x * x + sin(y);     // f.value, f.grad[0], f.grad[1]
+//
+// Plain doubles convert to constants (all derivatives zero).
+template<int N>
+struct Dual {
+    double value;
+    double grad[N];
+
+    Dual(double v = 0.0) : value(v) {
+        for (int k = 0; k < N; ++k) {
+            grad[k] = 0.0;
+        }
+    }
+
+    // Independent variable seeded in direction `direction`
+    Dual(double v, int direction) : Dual(v) {
+        grad[direction] = 1.0;
+    }
+
+    bool isConstant() const {
+        for (int k = 0; k < N; ++k) {
+            if (grad[k] != 0.0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    Dual& operator+=(const Dual& b) {
+        value += b.value;
+        for (int k = 0; k < N; ++k) grad[k] += b.grad[k];
+        return *this;
+    }
+
+    Dual& operator-=(const Dual& b) {
+        value -= b.value;
+        for (int k = 0; k < N; ++k) grad[k] -= b.grad[k];
+        return *this;
+    }
+
+    Dual& operator*=(const Dual& b) {
+        for (int k = 0; k < N; ++k) grad[k] = grad[k] * b.value + value * b.grad[k];
+        value *= b.value;
+        return *this;
+    }
+
+    Dual& operator/=(const Dual& b) {
+        double inv = 1.0 / b.value;
+        value *= inv;
+        for (int k = 0; k < N; ++k) grad[k] = (grad[k] - value * b.grad[k]) * inv;
+        return *this;
+    }
+
+    friend Dual operator+(Dual a, const Dual& b) { return a += b; }
+    friend Dual operator-(Dual a, const Dual& b) { return a -= b; }
+    friend Dual operator*(Dual a, const Dual& b) { return a *= b; }
+    friend Dual operator/(Dual a, const Dual& b) { return a /= b; }
+
+    friend Dual operator-(Dual a) {
+        a.value = -a.value;
+        for (int k = 0; k < N; ++k) a.grad[k] = -a.grad[k];
+        return a;
+    }
+
+    // f(a) with f'(a) = slope
+    static Dual chain(const Dual& a, double f, double slope) {
+        Dual r(f);
+        for (int k = 0; k < N; ++k) r.grad[k] = slope * a.grad[k];
+        return r;
+    }
+
+    friend Dual sin(const Dual& a) { return chain(a, std::sin(a.value), std::cos(a.value)); }
+    friend Dual cos(const Dual& a) { return chain(a, std::cos(a.value), -std::sin(a.value)); }
+    friend Dual exp(const Dual& a) { double e = std::exp(a.value); return chain(a, e, e); }
+    friend Dual log(const Dual& a) { return chain(a, std::log(a.value), 1.0 / a.value); }
+
+    friend Dual tan(const Dual& a) {
+        double t = std::tan(a.value);
+        return chain(a, t, 1.0 + t * t);
+    }
+
+    friend Dual sqrt(const Dual& a) {
+        double s = std::sqrt(a.value);
+        return chain(a, s, 0.5 / s);
+    }
+
+    // A constant exponent uses the power rule, so x^2 is fine for x <= 0
+    friend Dual pow(const Dual& a, const Dual& b) {
+        double p = std::pow(a.value, b.value);
+        if (b.isConstant()) {
+            return chain(a, p, b.value * std::pow(a.value, b.value - 1.0));
+        }
+        Dual r = chain(a, p, b.value * std::pow(a.value, b.value - 1.0));
+        double logA = std::log(a.value);
+        for (int k = 0; k < N; ++k) r.grad[k] += p * logA * b.grad[k];
+        return r;
+    }
+};
+
+#endif
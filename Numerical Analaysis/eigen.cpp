@@ -0,0 +1,649 @@
+#include <vector>
+#include <cmath>
+#include <stdexcept>
+#include <algorithm>
+#include <functional>
+
+#include "eigen.h"
+#include "solver_stats.h"
+
+using namespace std;
+
+void matrixVectorMultiply(const DenseMatrix &matrix, const vector<double> &vec, vector<double> &result) {
+    int rows = matrix.rows();
+    int cols = matrix.cols();
+    const double *x = vec.data();
+    double *y = result.data();
+    int blocks = (rows + 3) / 4;
+
+    #pragma omp parallel for schedule(static)
+    for (int block = 0; block < blocks; ++block) {
+        int i = 4 * block;
+        if (i + 4 <= rows) {
+            const double *a0 = matrix.row(i), *a1 = matrix.row(i + 1), *a2 = matrix.row(i + 2), *a3 = matrix.row(i + 3);
+            double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+            #pragma omp simd reduction(+:s0, s1, s2, s3)
+            for (int j = 0; j < cols; ++j) {
+                s0 += a0[j] * x[j];
+                s1 += a1[j] * x[j];
+                s2 += a2[j] * x[j];
+                s3 += a3[j] * x[j];
+            }
+            y[i] = s0;
+            y[i + 1] = s1;
+            y[i + 2] = s2;
+            y[i + 3] = s3;
+        } else {
+            for (; i < rows; ++i) {
+                const double *a = matrix.row(i);
+                double sum = 0.0;
+                #pragma omp simd reduction(+:sum)
+                for (int j = 0; j < cols; ++j) {
+                    sum += a[j] * x[j];
+                }
+                y[i] = sum;
+            }
+        }
+    }
+}
+
+void normalize(vector<double> &vec) {
+    double norm = 0.0;
+    for (double val : vec) {
+        norm += val * val;
+    }
+    norm = sqrt(norm);
+    for (double &val : vec) {
+        val /= norm;
+    }
+}
+
+double determinant(const DenseMatrix &matrix) {
+    if (matrix.rows() != matrix.cols()) {
+        throw runtime_error("Matrix must be square.");
+    }
+
+    int n = matrix.rows();
+    DenseMatrix temp(matrix);
+    double det = 1.0;
+
+    for (int i = 0; i < n; ++i) {
+        int pivot = i;
+        for (int j = i + 1; j < n; ++j) {
+            if (fabs(temp(j, i)) > fabs(temp(pivot, i))) {
+                pivot = j;
+            }
+        }
+
+        if (fabs(temp(pivot, i)) < 1e-10) {
+            return 0.0;
+        }
+
+        if (i != pivot) {
+            swap_ranges(temp.row(i), temp.row(i) + n, temp.row(pivot));
+            det = -det;
+        }
+
+        det *= temp(i, i);
+
+        for (int j = i + 1; j < n; ++j) {
+            temp(j, i) /= temp(i, i);
+            for (int k = i + 1; k < n; ++k) {
+                temp(j, k) -= temp(j, i) * temp(i, k);
+            }
+        }
+    }
+
+    return det;
+}
+
+double powerIteration(const DenseMatrix &matrix, vector<double> &vec, double epsilon, int maxIterations, bool aitken) {
+    int n = vec.size();
+    vector<double> newVec(n);
+    normalize(vec);
+
+    double lambda = 0.0;
+    double history[3] = {0.0, 0.0, 0.0};  // last three Rayleigh quotients
+    double previousExtrapolation = 0.0;
+    bool haveExtrapolation = false;
+
+    bool symmetric = true;
+    for (int i = 0; i < n && symmetric; ++i) {
+        for (int j = i + 1; j < n && symmetric; ++j) {
+            symmetric = matrix(i, j) == matrix(j, i);
+        }
+    }
+
+    SolveTimer timer("power_iteration");
+    double residual = NAN;
+    for (int iterations = 1; iterations <= maxIterations; ++iterations) {
+        matrixVectorMultiply(matrix, vec, newVec);
+
+        lambda = 0.0;
+        for (int i = 0; i < n; ++i) {
+            lambda += vec[i] * newVec[i];
+        }
+        residual = 0.0;
+        double norm = 0.0;
+        for (int i = 0; i < n; ++i) {
+            double r = newVec[i] - lambda * vec[i];
+            residual += r * r;
+            norm += newVec[i] * newVec[i];
+        }
+        residual = sqrt(residual);
+        norm = sqrt(norm);
+
+        if (norm == 0.0) {
+            timer.finish(iterations, iterations, residual);
+            return 0.0;  // vec is in the null space of the matrix
+        }
+        bool converged = residual <= epsilon * max(1.0, fabs(lambda));
+
+        history[0] = history[1];
+        history[1] = history[2];
+        history[2] = lambda;
+        if (aitken && iterations >= 3) {
+            double d0 = history[1] - history[0];
+            double d1 = history[2] - history[1];
+            double d2 = d1 - d0;
+            // Only extrapolate while the differences shrink geometrically
+            if (d2 != 0.0 && fabs(d1) < fabs(d0)) {
+                double extrapolation = history[2] - d1 * d1 / d2;
+                // The looser sqrt(epsilon) residual is only safe where the
+                // quotient error is the squared residual (symmetric matrices)
+                double bound = symmetric ? sqrt(epsilon) * max(1.0, fabs(lambda)) : epsilon * max(1.0, fabs(lambda));
+                if (haveExtrapolation && fabs(extrapolation - previousExtrapolation) <= epsilon * max(1.0, fabs(extrapolation))
+                        && residual <= bound) {
+                    timer.finish(iterations, iterations, residual);
+                    return extrapolation;
+                }
+                previousExtrapolation = extrapolation;
+                haveExtrapolation = true;
+            } else {
+                haveExtrapolation = false;
+            }
+        }
+        if (converged) {
+            timer.finish(iterations, iterations, residual);
+            return lambda;
+        }
+
+        for (int i = 0; i < n; ++i) {
+            vec[i] = newVec[i] / norm;
+        }
+    }
+    // Iteration cap reached: the extrapolated value is the better estimate
+    timer.finish(maxIterations, maxIterations, residual);
+    return haveExtrapolation ? previousExtrapolation : lambda;
+}
+
+double rayleighQuotient(const DenseMatrix &matrix, const vector<double> &vec, vector<double> &scratch) {
+    matrixVectorMultiply(matrix, vec, scratch);
+    double num = 0.0, den = 0.0;
+    for (size_t i = 0; i < vec.size(); ++i) {
+        num += vec[i] * scratch[i];
+        den += vec[i] * vec[i];
+    }
+    return num / den;
+}
+
+LUFactorization factorShifted(const DenseMatrix &matrix, double &shift) {
+    int n = matrix.rows();
+    for (int attempt = 0; ; ++attempt) {
+        DenseMatrix shifted(matrix);
+        for (int i = 0; i < n; ++i) {
+            shifted(i, i) -= shift;
+        }
+        try {
+            return LUFactorization(std::move(shifted));
+        } catch (runtime_error &) {
+            if (attempt == 2) {
+                throw;
+            }
+            shift += 1e-10 * max(1.0, fabs(shift));
+        }
+    }
+}
+
+double inverseIteration(const DenseMatrix &matrix, vector<double> &vec, double shift, double epsilon, bool rayleigh, int maxIterations) {
+    int n = vec.size();
+    vector<double> scratch(n);
+    SolveTimer timer(rayleigh ? "rayleigh_quotient_iteration" : "inverse_iteration");
+    LUFactorization lu = factorShifted(matrix, shift);
+    normalize(vec);
+
+    // Evaluations count the solves with the factors and the matrix-vector
+    // products of the Rayleigh quotients
+    int iterations = 0, evaluations = 0;
+    double change = NAN;
+    while (iterations < maxIterations) {
+        iterations++;
+        evaluations++;
+        scratch = vec;
+        lu.solveInPlace(scratch);
+        normalize(scratch);
+
+        // The iterate may flip sign every step when the eigenvalue of
+        // (A - shift * I)^-1 is negative, so compare against both signs
+        double diffSame = 0.0, diffFlip = 0.0;
+        for (int i = 0; i < n; ++i) {
+            diffSame += fabs(scratch[i] - vec[i]);
+            diffFlip += fabs(scratch[i] + vec[i]);
+        }
+        vec.swap(scratch);
+        change = min(diffSame, diffFlip);
+        if (change < epsilon) {
+            break;
+        }
+
+        if (rayleigh) {
+            double newShift = rayleighQuotient(matrix, vec, scratch);
+            evaluations++;
+            try {
+                lu = factorShifted(matrix, newShift);
+            } catch (runtime_error &) {
+                break;  // The shift hit an eigenvalue exactly
+            }
+            shift = newShift;
+        }
+    }
+
+    double lambda = rayleighQuotient(matrix, vec, scratch);
+    timer.finish(iterations, evaluations + 1, change);
+    return lambda;
+}
+
+const int BlockTile = 512;  // columns of a block kept in cache at a time
+
+void multiplyBlock(const DenseMatrix &A, const DenseMatrix &X, DenseMatrix &Y) {
+    int n = A.rows(), p = X.rows();
+    fill(Y.data(), Y.data() + static_cast<size_t>(p) * n, 0.0);
+    for (int j0 = 0; j0 < n; j0 += BlockTile) {
+        int j1 = min(j0 + BlockTile, n);
+        #pragma omp parallel for schedule(static)
+        for (int i = 0; i < n; ++i) {
+            const double *a = A.row(i);
+            for (int r = 0; r < p; ++r) {
+                const double *x = X.row(r);
+                double sum = 0.0;
+                #pragma omp simd reduction(+:sum)
+                for (int j = j0; j < j1; ++j) {
+                    sum += a[j] * x[j];
+                }
+                Y(r, i) += sum;
+            }
+        }
+    }
+}
+
+BlockOperator denseOperator(const DenseMatrix &A) {
+    return [&A](const DenseMatrix &X, DenseMatrix &Y) { multiplyBlock(A, X, Y); };
+}
+
+BlockOperator vectorOperator(function<void(const double *x, double *y)> matvec) {
+    return [matvec](const DenseMatrix &X, DenseMatrix &Y) {
+        for (int r = 0; r < X.rows(); ++r) {
+            matvec(X.row(r), Y.row(r));
+        }
+    };
+}
+
+DenseMatrix innerProducts(const DenseMatrix &X, const DenseMatrix &Y) {
+    int p = X.rows(), q = Y.rows(), n = X.cols();
+    DenseMatrix G(p, q);
+    #pragma omp parallel for schedule(static)
+    for (int a = 0; a < p; ++a) {
+        const double *x = X.row(a);
+        for (int b = 0; b < q; ++b) {
+            const double *y = Y.row(b);
+            double sum = 0.0;
+            #pragma omp simd reduction(+:sum)
+            for (int j = 0; j < n; ++j) {
+                sum += x[j] * y[j];
+            }
+            G(a, b) = sum;
+        }
+    }
+    return G;
+}
+
+DenseMatrix combineRows(const DenseMatrix &S, const DenseMatrix &X, int count) {
+    int m = S.rows(), n = X.cols();
+    DenseMatrix Z(count, n);
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < count; ++i) {
+        double *z = Z.row(i);
+        for (int r = 0; r < m; ++r) {
+            double s = S(r, i);
+            const double *x = X.row(r);
+            #pragma omp simd
+            for (int j = 0; j < n; ++j) {
+                z[j] += s * x[j];
+            }
+        }
+    }
+    return Z;
+}
+
+void gramSchmidtRows(DenseMatrix &X) {
+    int p = X.rows(), n = X.cols();
+    for (int i = 0; i < p; ++i) {
+        double *xi = X.row(i);
+        for (int pass = 0; pass < 2; ++pass) {
+            for (int r = 0; r < i; ++r) {
+                const double *xr = X.row(r);
+                double dot = 0.0;
+                for (int j = 0; j < n; ++j) {
+                    dot += xi[j] * xr[j];
+                }
+                for (int j = 0; j < n; ++j) {
+                    xi[j] -= dot * xr[j];
+                }
+            }
+        }
+        double norm = 0.0;
+        for (int j = 0; j < n; ++j) {
+            norm += xi[j] * xi[j];
+        }
+        norm = sqrt(norm);
+        if (norm < 1e-300) {
+            throw runtime_error("Block vectors are linearly dependent.");
+        }
+        for (int j = 0; j < n; ++j) {
+            xi[j] /= norm;
+        }
+    }
+}
+
+void orthonormalizeRows(DenseMatrix &X) {
+    int p = X.rows(), n = X.cols();
+    for (int pass = 0; pass < 2; ++pass) {
+        DenseMatrix L = innerProducts(X, X);
+        for (int i = 0; i < p; ++i) {
+            for (int k = 0; k < i; ++k) {
+                double sum = L(i, k);
+                for (int r = 0; r < k; ++r) {
+                    sum -= L(i, r) * L(k, r);
+                }
+                L(i, k) = sum / L(k, k);
+            }
+            double d = L(i, i);
+            for (int r = 0; r < i; ++r) {
+                d -= L(i, r) * L(i, r);
+            }
+            if (d <= 1e-14 * L(i, i) || d <= 0.0) {
+                gramSchmidtRows(X);
+                return;
+            }
+            L(i, i) = sqrt(d);
+        }
+
+        // Forward substitution on all columns at once, split by column tiles
+        #pragma omp parallel for schedule(static)
+        for (int j0 = 0; j0 < n; j0 += BlockTile) {
+            int j1 = min(j0 + BlockTile, n);
+            for (int i = 0; i < p; ++i) {
+                double *xi = X.row(i);
+                for (int r = 0; r < i; ++r) {
+                    double l = L(i, r);
+                    const double *xr = X.row(r);
+                    for (int j = j0; j < j1; ++j) {
+                        xi[j] -= l * xr[j];
+                    }
+                }
+                double inv = 1.0 / L(i, i);
+                for (int j = j0; j < j1; ++j) {
+                    xi[j] *= inv;
+                }
+            }
+        }
+    }
+}
+
+void symmetricEigen(DenseMatrix H, vector<double> &values, DenseMatrix &vectors) {
+    int m = H.rows();
+    vectors = DenseMatrix::identity(m);
+    for (int sweep = 0; sweep < 100; ++sweep) {
+        double off = 0.0, total = 0.0;
+        for (int i = 0; i < m; ++i) {
+            for (int j = 0; j < m; ++j) {
+                total += H(i, j) * H(i, j);
+                if (i != j) {
+                    off += H(i, j) * H(i, j);
+                }
+            }
+        }
+        if (off <= 1e-30 * total) {
+            break;
+        }
+        for (int p = 0; p < m - 1; ++p) {
+            for (int q = p + 1; q < m; ++q) {
+                if (H(p, q) == 0.0) {
+                    continue;
+                }
+                double theta = (H(q, q) - H(p, p)) / (2.0 * H(p, q));
+                double t = (theta >= 0 ? 1.0 : -1.0) / (fabs(theta) + sqrt(theta * theta + 1.0));
+                double c = 1.0 / sqrt(t * t + 1.0), s = t * c;
+                for (int k = 0; k < m; ++k) {
+                    double hkp = H(k, p), hkq = H(k, q);
+                    H(k, p) = c * hkp - s * hkq;
+                    H(k, q) = s * hkp + c * hkq;
+                }
+                for (int k = 0; k < m; ++k) {
+                    double hpk = H(p, k), hqk = H(q, k);
+                    H(p, k) = c * hpk - s * hqk;
+                    H(q, k) = s * hpk + c * hqk;
+                }
+                for (int k = 0; k < m; ++k) {
+                    double vkp = vectors(k, p), vkq = vectors(k, q);
+                    vectors(k, p) = c * vkp - s * vkq;
+                    vectors(k, q) = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+    values.resize(m);
+    for (int i = 0; i < m; ++i) {
+        values[i] = H(i, i);
+    }
+}
+
+vector<int> byMagnitude(const vector<double> &values) {
+    vector<int> order(values.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    sort(order.begin(), order.end(), [&values](int a, int b) { return fabs(values[a]) > fabs(values[b]); });
+    return order;
+}
+
+DenseMatrix randomBlock(int p, int n) {
+    DenseMatrix X(p, n);
+    unsigned long long state = 0x9E3779B97F4A7C15ULL;
+    for (size_t k = 0; k < static_cast<size_t>(p) * n; ++k) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        X.data()[k] = static_cast<double>(state >> 11) / 9007199254740992.0 - 0.5;
+    }
+    return X;
+}
+
+EigenPairs subspaceIteration(const BlockOperator &A, int n, int k, double epsilon, int maxIterations) {
+    int p = min(n, k + max(k, 8));
+    DenseMatrix Q = randomBlock(p, n);
+    orthonormalizeRows(Q);
+    DenseMatrix Y(p, n);
+
+    SolveTimer timer("subspace_iteration");
+    EigenPairs result;
+    for (int iteration = 1; iteration <= maxIterations; ++iteration) {
+        A(Q, Y);
+        result.matvecs += p;
+        result.iterations = iteration;
+
+        // Rayleigh-Ritz: H = Q A Q^T, Ritz vectors X = S^T Q, A X = S^T Y
+        DenseMatrix H = innerProducts(Q, Y);
+        for (int i = 0; i < p; ++i) {
+            for (int j = i + 1; j < p; ++j) {
+                H(i, j) = H(j, i) = 0.5 * (H(i, j) + H(j, i));
+            }
+        }
+        vector<double> theta;
+        DenseMatrix S;
+        symmetricEigen(H, theta, S);
+        vector<int> order = byMagnitude(theta);
+        DenseMatrix sorted(p, p);
+        vector<double> sortedTheta(p);
+        for (int c = 0; c < p; ++c) {
+            sortedTheta[c] = theta[order[c]];
+            for (int r = 0; r < p; ++r) {
+                sorted(r, c) = S(r, order[c]);
+            }
+        }
+        DenseMatrix X = combineRows(sorted, Q, p);
+        DenseMatrix AX = combineRows(sorted, Y, p);
+
+        // The residual of the last pair tested (the first unconverged one)
+        bool converged = true;
+        double residual = NAN;
+        for (int i = 0; i < k && converged; ++i) {
+            residual = 0.0;
+            for (int j = 0; j < n; ++j) {
+                double d = AX(i, j) - sortedTheta[i] * X(i, j);
+                residual += d * d;
+            }
+            residual = sqrt(residual);
+            converged = residual <= epsilon * max(1.0, fabs(sortedTheta[i]));
+        }
+
+        if (converged || iteration == maxIterations) {
+            result.converged = converged;
+            result.values.assign(sortedTheta.begin(), sortedTheta.begin() + k);
+            result.vectors = DenseMatrix(k, n);
+            copy(X.data(), X.data() + static_cast<size_t>(k) * n, result.vectors.data());
+            timer.finish(result.iterations, result.matvecs, residual);
+            return result;
+        }
+
+        // Next block: A applied to the Ritz vectors, re-orthonormalized
+        Q = move(AX);
+        orthonormalizeRows(Q);
+    }
+    return result;
+}
+
+EigenPairs lanczos(const BlockOperator &A, int n, int k, double epsilon, int maxRestarts) {
+    int m = min(n, max(2 * k + 1, k + 20));
+    int keep = min(m - 1, k + (m - k) / 2);
+    DenseMatrix V(m, n);          // basis, one vector per row
+    DenseMatrix H(m, m);          // projection V A V^T
+    DenseMatrix w(1, n), v(1, n);
+    DenseMatrix start = randomBlock(1, n);
+    gramSchmidtRows(start);
+    copy(start.row(0), start.row(0) + n, V.row(0));
+
+    SolveTimer timer("lanczos");
+    EigenPairs result;
+    int first = 0;
+    for (int restart = 1; restart <= maxRestarts; ++restart) {
+        result.iterations = restart;
+        double beta = 0.0;
+        vector<double> residual(n);
+
+        for (int j = first; j < m; ++j) {
+            copy(V.row(j), V.row(j) + n, v.row(0));
+            A(v, w);
+            result.matvecs++;
+            double *wj = w.row(0);
+
+            // Full reorthogonalization (twice) against the basis so far
+            for (int pass = 0; pass < 2; ++pass) {
+                for (int i = 0; i <= j; ++i) {
+                    const double *vi = V.row(i);
+                    double h = 0.0;
+                    #pragma omp simd reduction(+:h)
+                    for (int c = 0; c < n; ++c) {
+                        h += vi[c] * wj[c];
+                    }
+                    #pragma omp simd
+                    for (int c = 0; c < n; ++c) {
+                        wj[c] -= h * vi[c];
+                    }
+                    H(i, j) += h;
+                }
+            }
+            for (int i = 0; i < j; ++i) {
+                H(j, i) = H(i, j);
+            }
+
+            beta = 0.0;
+            for (int c = 0; c < n; ++c) {
+                beta += wj[c] * wj[c];
+            }
+            beta = sqrt(beta);
+            if (j + 1 == m) {
+                copy(wj, wj + n, residual.begin());
+                break;
+            }
+
+            if (beta < 1e-12 * max(1.0, fabs(H(j, j)))) {
+                // Invariant subspace found: continue with a new direction
+                DenseMatrix basis(j + 2, n);
+                copy(V.data(), V.data() + static_cast<size_t>(j + 1) * n, basis.data());
+                DenseMatrix fresh = randomBlock(1, n);
+                copy(fresh.row(0), fresh.row(0) + n, basis.row(j + 1));
+                gramSchmidtRows(basis);
+                copy(basis.row(j + 1), basis.row(j + 1) + n, V.row(j + 1));
+            } else {
+                double *next = V.row(j + 1);
+                for (int c = 0; c < n; ++c) {
+                    next[c] = wj[c] / beta;
+                }
+            }
+            // H(j, j + 1) = beta is picked up when column j + 1 is orthogonalized
+        }
+
+        vector<double> theta;
+        DenseMatrix S;
+        symmetricEigen(H, theta, S);
+        vector<int> order = byMagnitude(theta);
+        DenseMatrix sorted(m, m);
+        for (int c = 0; c < m; ++c) {
+            for (int r = 0; r < m; ++r) {
+                sorted(r, c) = S(r, order[c]);
+            }
+        }
+
+        // Residual of Ritz pair i is beta * |last component of its vector|
+        bool converged = true;
+        double ritzResidual = NAN;
+        for (int i = 0; i < k && converged; ++i) {
+            ritzResidual = beta * fabs(sorted(m - 1, i));
+            converged = ritzResidual <= epsilon * max(1.0, fabs(theta[order[i]]));
+        }
+
+        if (converged || restart == maxRestarts || m == n) {
+            result.converged = converged || m == n;
+            result.values.resize(k);
+            for (int i = 0; i < k; ++i) {
+                result.values[i] = theta[order[i]];
+            }
+            result.vectors = combineRows(sorted, V, k);
+            timer.finish(result.iterations, result.matvecs, ritzResidual);
+            return result;
+        }
+
+        // Thick restart: keep the best Ritz vectors plus the residual direction
+        DenseMatrix kept = combineRows(sorted, V, keep);
+        copy(kept.data(), kept.data() + static_cast<size_t>(keep) * n, V.data());
+        H = DenseMatrix(m, m);
+        for (int i = 0; i < keep; ++i) {
+            H(i, i) = theta[order[i]];
+        }
+        double *next = V.row(keep);
+        for (int c = 0; c < n; ++c) {
+            next[c] = residual[c] / beta;
+        }
+        first = keep;
+    }
+    return result;
+}
@@ -0,0 +1,127 @@
+#ifndef EIGEN_H
+#define EIGEN_H
+
+#include <functional>
+#include <vector>
+
+#include "dense_matrix.h"
+#include "lu.h"
+
+// Function to multiply a matrix by a vector: result = matrix * vec.
+// result must already have matrix.rows() entries, so nothing is allocated.
+// Rows are processed four at a time so every loaded entry of vec is used
+// four times, the inner loop is vectorized, and the row blocks are split
+// across threads with OpenMP.
+void matrixVectorMultiply(const DenseMatrix &matrix, const std::vector<double> &vec, std::vector<double> &result);
+
+// Function to normalize a vector
+void normalize(std::vector<double> &vec);
+
+// Function to calculate the determinant of a matrix (assumes square matrix)
+double determinant(const DenseMatrix &matrix);
+
+// Function to calculate the largest eigenvalue using power iteration.
+// vec and one scratch buffer are used in turn as input and output of the
+// matrix-vector product, so the loop does not allocate or copy vectors.
+//
+// Every step yields the Rayleigh quotient lambda = v.Av of the normalized
+// iterate and the residual |Av - lambda v|; the iteration stops once the
+// residual is below epsilon * max(1, |lambda|). The residual test does not
+// care about the sign of the iterate, so a negative dominant eigenvalue
+// (where v flips sign every step) converges like a positive one.
+//
+// When the two largest eigenvalues are close, the Rayleigh quotients
+// converge slowly but geometrically; with `aitken` set, Aitken's delta-squared
+// extrapolation of the last three quotients is tracked as well, and the
+// iteration stops with the extrapolated value once two successive
+// extrapolations agree to epsilon and the residual is below sqrt(epsilon)
+// (the Rayleigh quotient error scales with the squared residual, so this
+// guards against stopping on a plateau near a subdominant eigenvalue).
+// That scaling only holds for symmetric matrices: for any other matrix the
+// extrapolated value needs the full residual test, and it is preferred over
+// the last quotient when both pass, since a small residual of a nonnormal
+// matrix can still leave the quotient far from the eigenvalue.
+double powerIteration(const DenseMatrix &matrix, std::vector<double> &vec, double epsilon, int maxIterations = 1000, bool aitken = true);
+
+// Rayleigh quotient v.Av / v.v, using scratch as the product buffer
+double rayleighQuotient(const DenseMatrix &matrix, const std::vector<double> &vec, std::vector<double> &scratch);
+
+// Factor (A - shift * I); an exactly singular shift is moved by a tiny amount
+LUFactorization factorShifted(const DenseMatrix &matrix, double &shift);
+
+// Function to calculate the eigenvalue closest to `shift` using shifted
+// inverse iteration. (A - shift * I) is factored once and every iteration is
+// one pair of O(n^2) triangular solves. With `rayleigh` set, the shift is
+// replaced by the Rayleigh quotient after each step (Rayleigh quotient
+// iteration); this refactors every step but converges cubically for
+// symmetric matrices.
+double inverseIteration(const DenseMatrix &matrix, std::vector<double> &vec, double shift, double epsilon, bool rayleigh, int maxIterations = 1000);
+
+// ---------------------------------------------------------------------------
+// Leading eigenpairs of symmetric matrices
+//
+// A block of p vectors of length n is stored as a p x n DenseMatrix, one
+// vector per row. The solvers only see the matrix through a BlockOperator,
+// which computes Y = A X for a whole block, so they also work with
+// matrix-free operators.
+// ---------------------------------------------------------------------------
+
+typedef std::function<void(const DenseMatrix &X, DenseMatrix &Y)> BlockOperator;
+
+// Y = A X for a dense symmetric A. Each tile of a row of A is loaded once and
+// used for every vector of the block (BLAS-3 style), while the matching tile
+// of X stays in cache; rows of A are split across threads.
+void multiplyBlock(const DenseMatrix &A, const DenseMatrix &X, DenseMatrix &Y);
+
+BlockOperator denseOperator(const DenseMatrix &A);
+
+// Wrap a single-vector product y = A x (matrix-free) as a block operator
+BlockOperator vectorOperator(std::function<void(const double *x, double *y)> matvec);
+
+// G = X Y^T (inner products of all row pairs)
+DenseMatrix innerProducts(const DenseMatrix &X, const DenseMatrix &Y);
+
+// Z = S^T X, i.e. row i of Z is sum_r S(r, i) * X.row(r), for the first
+// `count` columns of S and the first S.rows() rows of X
+DenseMatrix combineRows(const DenseMatrix &S, const DenseMatrix &X, int count);
+
+// Orthonormalize the rows of X with modified Gram-Schmidt (fallback path)
+void gramSchmidtRows(DenseMatrix &X);
+
+// Orthonormalize the rows of X with Cholesky QR applied twice: G = X X^T,
+// G = L L^T, X := L^-1 X. Falls back to Gram-Schmidt if G is not positive.
+void orthonormalizeRows(DenseMatrix &X);
+
+// Eigen-decomposition of a small symmetric matrix with the cyclic Jacobi
+// method. Eigenvector i is column i of `vectors`.
+void symmetricEigen(DenseMatrix H, std::vector<double> &values, DenseMatrix &vectors);
+
+// Indices of the eigenvalues sorted by decreasing magnitude
+std::vector<int> byMagnitude(const std::vector<double> &values);
+
+// Deterministic pseudo-random start block
+DenseMatrix randomBlock(int p, int n);
+
+struct EigenPairs {
+    std::vector<double> values;  // sorted by decreasing magnitude
+    DenseMatrix vectors;         // eigenvector i is row i
+    int iterations = 0;
+    int matvecs = 0;             // single-vector products with A
+    bool converged = false;
+};
+
+// Subspace (block power) iteration with Rayleigh-Ritz projection for the k
+// eigenvalues of largest magnitude. A block of p = k + extra vectors is
+// multiplied by A once per iteration; the Ritz pairs of the projected p x p
+// matrix give the eigenvalue estimates and their residuals.
+EigenPairs subspaceIteration(const BlockOperator &A, int n, int k, double epsilon, int maxIterations = 1000);
+
+// Lanczos with full reorthogonalization and thick restart for the k
+// eigenvalues of largest magnitude. A basis of m vectors is built one
+// product at a time; at a restart the k + (m - k) / 2 best Ritz vectors and
+// the residual are kept and the basis is extended again. Keeping Ritz
+// vectors this way (Wu & Simon) is equivalent to implicitly restarted
+// Lanczos with exact shifts, but needs no QR sweeps on the tridiagonal.
+EigenPairs lanczos(const BlockOperator &A, int n, int k, double epsilon, int maxRestarts = 1000);
+
+#endif
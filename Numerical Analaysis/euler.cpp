@@ -2,67 +2,31 @@
 #include <functional>
 #include <string>
 #include <cmath>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
 
-// Simple parser to evaluate the function (limited to specific expressions for simplicity)
-double evaluateFunction(const std::function<double(double, double)>& func, double x, double y) {
-    return func(x, y);
-}
-
-std::function<double(double, double)> parseFunction(const std::string& expression) {
-    return [expression](double x, double y) {
-        // This is a very basic and limited parser, only for demonstration purposes.
-        // You can expand this parser or use a library like muParser for more complex expressions.
-        if (expression == "3*x - x*y") {
-            return 3*x - x*y;
-        }
-        // Add more cases for different expressions if needed.
-        return 0.0; // Default case
-    };
-}
+#include "batch_io.h"
+#include "ode.h"
+#include "trajectory_writer.h"
 
-// Euler's Method
-double eulerMethod(double x0, double y0, double h, int steps, const std::function<double(double, double)>& func) {
-    double x = x0, y = y0;
-    for (int i = 0; i < steps; i++) {
-        y = y + h * evaluateFunction(func, x, y);
-        x = x + h;
+// Throughput run: integrates `count` trajectories with y0 spread around the
+// given value and returns trajectories per second for RK4
+template <typename F>
+double batchThroughput(size_t count, double x0, double y0, double h, int steps, F func) {
+    std::vector<double> x(count, x0), y(count);
+    for (size_t i = 0; i < count; i++) {
+        y[i] = y0 + 1e-3 * static_cast<double>(i) / count;
     }
-    return y;
+    auto begin = std::chrono::steady_clock::now();
+    rungeKutta4Batch(x.data(), y.data(), count, h, steps, func);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    return count / seconds;
 }
 
-// Second-order Runge-Kutta Method (Heun's Method)
-double rungeKutta2(double x0, double y0, double h, int steps, const std::function<double(double, double)>& func) {
-    double x = x0, y = y0;
-    for (int i = 0; i < steps; i++) {
-        double k1 = evaluateFunction(func, x, y);
-        double k2 = evaluateFunction(func, x + h, y + h * k1);
-        y = y + (h/2) * (k1 + k2);
-        x = x + h;
-    }
-    return y;
-}
-
-// Fourth-order Runge-Kutta Method
-double rungeKutta4(double x0, double y0, double h, int steps, const std::function<double(double, double)>& func) {
-    double x = x0, y = y0;
-    for (int i = 0; i < steps; i++) {
-        double k1 = evaluateFunction(func, x, y);
-        double k2 = evaluateFunction(func, x + h/2, y + h*k1/2);
-        double k3 = evaluateFunction(func, x + h/2, y + h*k2/2);
-        double k4 = evaluateFunction(func, x + h, y + h*k3);
-        y = y + (h/6) * (k1 + 2*k2 + 2*k3 + k4);
-        x = x + h;
-    }
-    return y;
-}
-
-int main() {
-    std::string expression;
-    std::cout << "Enter the differential equation in the form of f(x, y) = ";
-    std::cin >> expression;
-
-    auto func = parseFunction(expression);
-
+template <typename F>
+int runSolvers(const F& func) {
     double x0 = 0.0, y0 = 4.0, h = 0.1;
     int steps = 10; // Since we want y(1) and h = 0.1, steps = (1 - 0)/0.1 = 10
 
@@ -74,5 +38,128 @@ int main() {
     std::cout << "Using Second-order Runge-Kutta Method: y(1) = " << y_rk2 << std::endl;
     std::cout << "Using Fourth-order Runge-Kutta Method: y(1) = " << y_rk4 << std::endl;
 
+    double tolerance;
+    std::cout << "Enter the tolerance for the adaptive Dormand-Prince RK45 method: ";
+    std::cin >> tolerance;
+    StepStats stats;
+    try {
+        double y_dp = dormandPrince(x0, y0, x0 + steps * h, tolerance, tolerance, func, stats);
+        std::cout << "Using adaptive Dormand-Prince RK45 Method: y(1) = " << y_dp
+                  << " (accepted steps = " << stats.accepted << ", rejected steps = " << stats.rejected
+                  << ", function evaluations = " << stats.evaluations << ")" << std::endl;
+    } catch (std::runtime_error& e) {
+        std::cerr << "Dormand-Prince RK45 Method failed: " << e.what() << std::endl;
+    }
+
+    std::string path;
+    std::cout << "Enter a file name to stream the RK4 trajectory to (- to skip): ";
+    std::cin >> path;
+    if (path != "-") {
+        int every;
+        std::cout << "Write every n-th step, n = (0 for dense output at given x values): ";
+        std::cin >> every;
+        std::vector<double> times;
+        if (every <= 0) {
+            int m;
+            std::cout << "Enter the number of x values: ";
+            std::cin >> m;
+            times.resize(m);
+            std::cout << "Enter the x values: ";
+            for (int i = 0; i < m; i++) {
+                std::cin >> times[i];
+            }
+        }
+        try {
+            TrajectoryWriter writer(path, every > 0 ? (steps + every - 1) / every + 1 : times.size(), every <= 0);
+            TrajectoryOutput output = every > 0 ? TrajectoryOutput(writer, every) : TrajectoryOutput(writer, times);
+            rungeKutta4(x0, y0, h, steps, func, &output);
+            writer.close();
+            std::cout << "Wrote " << writer.size() << " samples to " << path << std::endl;
+        } catch (std::runtime_error& e) {
+            std::cerr << e.what() << std::endl;
+            return -1;
+        }
+    }
+
+    size_t trajectories;
+    std::cout << "Enter the number of trajectories for a batch RK4 run (0 to skip): ";
+    std::cin >> trajectories;
+    if (trajectories > 0) {
+        double rate = batchThroughput(trajectories, x0, y0, h, steps, func);
+        std::cout << "Batch RK4 throughput: " << rate << " trajectories/s" << std::endl;
+    }
+
+    return 0;
+}
+
+// Batch mode: the first line holds f(x, y), then each record is
+// "x0 y0 h steps tolerance" and the output line is y(x0 + steps * h) by
+// Euler, RK2, RK4 and adaptive Dormand-Prince (tolerance used as both the
+// absolute and the relative one); an error line if Dormand-Prince fails
+template <typename F>
+int solveRecords(RecordReader& in, RecordWriter& out, const F& func) {
+    while (!in.atEnd()) {
+        double x0 = in.number();
+        double y0 = in.number();
+        double h = in.number();
+        int steps = in.integer();
+        double tolerance = in.number();
+        if (steps < 0) {
+            in.fail("negative step count");
+        }
+        double yDp;
+        try {
+            StepStats stats;
+            yDp = dormandPrince(x0, y0, x0 + steps * h, tolerance, tolerance, func, stats);
+        } catch (std::runtime_error& e) {
+            out.error(e.what());
+            continue;
+        }
+        out.number(eulerMethod(x0, y0, h, steps, func))
+           .number(rungeKutta2(x0, y0, h, steps, func))
+           .number(rungeKutta4(x0, y0, h, steps, func))
+           .number(yDp);
+        out.endRecord();
+    }
     return 0;
 }
+
+int runBatch(const std::string& path) {
+    RecordWriter out(std::cout);
+    try {
+        RecordReader in(path);
+        std::string expression = in.textLine();
+        if (expression == ExampleRhs::expression) {
+            return solveRecords(in, out, ExampleRhs());
+        }
+        return solveRecords(in, out, parseFunction(expression));
+    } catch (std::runtime_error& e) {
+        out.flush();
+        std::cerr << e.what() << std::endl;
+        return -1;
+    }
+}
+
+int main(int argc, char** argv) {
+    BatchOptions batch;
+    if (batchMode(argc, argv, batch)) {
+        return runBatchMode(batch, runBatch);
+    }
+
+    std::string expression;
+    std::cout << "Enter the differential equation in the form of f(x, y) = ";
+    std::getline(std::cin, expression);
+
+    // Known right-hand sides get the inlined path, anything else the type-erased one
+    if (expression == ExampleRhs::expression) {
+        return runSolvers(ExampleRhs());
+    }
+    RhsFunction func;
+    try {
+        func = parseFunction(expression);
+    } catch (std::runtime_error& e) {
+        std::cerr << e.what() << std::endl;
+        return -1;
+    }
+    return runSolvers(func);
+}
@@ -0,0 +1,312 @@
+#ifndef EXPRESSION_H
+#define EXPRESSION_H
+
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Expression compiled once into postfix bytecode and evaluated many times.
+// Supports variables (x and y unless other names are given), numbers,
+// + - * / ^ (right associative), unary minus, parentheses and the functions
+// sin, cos, tan, exp, log, sqrt.
+//
+//   Expression f("cos(x) - x");
+//   double fx = f(0.5);
+//
+//   Expression g("x1*x2 - x3", {"x1", "x2", "x3"});
+//   double gx = g.evaluate(values);   // values[0..2]
+//
+// Evaluation runs over a fixed-size stack and does not allocate.
+// evaluate() is a template over the number type, so the same bytecode
+// also runs on dual numbers for forward-mode differentiation.
+class Expression {
+public:
+    static const int MaxStackDepth = 64;
+
+    Expression() {}
+
+    explicit Expression(const std::string& source, const std::vector<std::string>& variables = {"x", "y"})
+        : variableCount(variables.size()), text(source), names(variables), pos(0), depth(0) {
+        skipSpaces();
+        if (pos == text.size()) {
+            fail("empty expression");
+        }
+        parseSum();
+        skipSpaces();
+        if (pos != text.size()) {
+            fail("unexpected character");
+        }
+        text.clear();
+        names.clear();
+    }
+
+    // Evaluate with vars[i] as the value of the i-th variable.
+    // T is double, or any number type with the arithmetic operators and
+    // sin/cos/tan/exp/log/sqrt/pow found by argument-dependent lookup, e.g.
+    // Dual<N> from dual.h to get exact derivatives in the same pass.
+    // A default-constructed (empty) expression has no value and throws
+    // std::runtime_error.
+    template<typename T>
+    T evaluate(const T* vars) const {
+        using std::sin; using std::cos; using std::tan;
+        using std::exp; using std::log; using std::sqrt; using std::pow;
+        if (code.empty()) {
+            throw std::runtime_error("Expression error: evaluating an empty expression");
+        }
+        // The parser keeps the depth within MaxStackDepth and leaves exactly
+        // one value, so stack[0] is always written; it is set anyway so the
+        // result is never read from uninitialized memory
+        T stack[MaxStackDepth];
+        stack[0] = T(0);
+        int top = -1;
+        for (const Instruction& in : code) {
+            switch (in.op) {
+                case PushConst: stack[++top] = T(in.value); break;
+                case PushVar:   stack[++top] = vars[in.index]; break;
+                case Add:  --top; stack[top] += stack[top + 1]; break;
+                case Sub:  --top; stack[top] -= stack[top + 1]; break;
+                case Mul:  --top; stack[top] *= stack[top + 1]; break;
+                case Div:  --top; stack[top] /= stack[top + 1]; break;
+                case Pow:  --top; stack[top] = pow(stack[top], stack[top + 1]); break;
+                case Neg:  stack[top] = -stack[top]; break;
+                case Sin:  stack[top] = sin(stack[top]); break;
+                case Cos:  stack[top] = cos(stack[top]); break;
+                case Tan:  stack[top] = tan(stack[top]); break;
+                case Exp:  stack[top] = exp(stack[top]); break;
+                case Log:  stack[top] = log(stack[top]); break;
+                case Sqrt: stack[top] = sqrt(stack[top]); break;
+            }
+        }
+        return stack[0];
+    }
+
+    // Evaluate an expression in at most two variables; throws
+    // std::runtime_error if it was compiled with more
+    double evaluate(double x, double y = 0.0) const {
+        if (variableCount > 2) {
+            throw std::runtime_error("Expression error: " + std::to_string(variableCount)
+                                     + " variables given to a two-variable evaluation");
+        }
+        const double vars[2] = {x, y};
+        return evaluate(vars);
+    }
+
+    double operator()(double x, double y = 0.0) const {
+        return evaluate(x, y);
+    }
+
+    int variables() const {
+        return variableCount;
+    }
+
+    bool empty() const {
+        return code.empty();
+    }
+
+private:
+    enum Op { PushConst, PushVar, Add, Sub, Mul, Div, Pow, Neg, Sin, Cos, Tan, Exp, Log, Sqrt };
+
+    struct Instruction {
+        Op op;
+        double value;
+        int index;
+    };
+
+    std::vector<Instruction> code;
+    int variableCount = 0;
+
+    // Parser state, only used while compiling
+    std::string text;
+    std::vector<std::string> names;
+    size_t pos = 0;
+    int depth = 0;
+
+    [[noreturn]] void fail(const std::string& message) const {
+        throw std::runtime_error("Expression error: " + message + " at position " + std::to_string(pos));
+    }
+
+    void skipSpaces() {
+        while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) {
+            pos++;
+        }
+    }
+
+    bool accept(char c) {
+        skipSpaces();
+        if (pos < text.size() && text[pos] == c) {
+            pos++;
+            return true;
+        }
+        return false;
+    }
+
+    void emit(Op op, double value = 0.0, int index = 0) {
+        if (op == PushConst || op == PushVar) {
+            if (++depth > MaxStackDepth) {
+                fail("expression is nested too deeply");
+            }
+        } else if (op == Add || op == Sub || op == Mul || op == Div || op == Pow) {
+            depth--;
+        }
+        code.push_back({op, value, index});
+        foldConstants();
+    }
+
+    // Replace an operator applied to constants by its result
+    void foldConstants() {
+        size_t n = code.size();
+        Op op = code[n - 1].op;
+        bool binary = op == Add || op == Sub || op == Mul || op == Div || op == Pow;
+        bool unary = !binary && op != PushConst && op != PushVar;
+        if (binary && n >= 3 && code[n - 2].op == PushConst && code[n - 3].op == PushConst) {
+            double a = code[n - 3].value, b = code[n - 2].value, r = 0.0;
+            switch (op) {
+                case Add: r = a + b; break;
+                case Sub: r = a - b; break;
+                case Mul: r = a * b; break;
+                case Div: r = a / b; break;
+                default:  r = std::pow(a, b); break;
+            }
+            code.resize(n - 2);
+            code.back() = {PushConst, r, 0};
+        } else if (unary && n >= 2 && code[n - 2].op == PushConst) {
+            double a = code[n - 2].value, r = 0.0;
+            switch (op) {
+                case Neg:  r = -a; break;
+                case Sin:  r = std::sin(a); break;
+                case Cos:  r = std::cos(a); break;
+                case Tan:  r = std::tan(a); break;
+                case Exp:  r = std::exp(a); break;
+                case Log:  r = std::log(a); break;
+                default:   r = std::sqrt(a); break;
+            }
+            code.pop_back();
+            code.back() = {PushConst, r, 0};
+        }
+    }
+
+    // sum := product (('+' | '-') product)*
+    void parseSum() {
+        parseProduct();
+        while (true) {
+            if (accept('+')) {
+                parseProduct();
+                emit(Add);
+            } else if (accept('-')) {
+                parseProduct();
+                emit(Sub);
+            } else {
+                break;
+            }
+        }
+    }
+
+    // product := unary (('*' | '/') unary)*
+    void parseProduct() {
+        parseUnary();
+        while (true) {
+            if (accept('*')) {
+                parseUnary();
+                emit(Mul);
+            } else if (accept('/')) {
+                parseUnary();
+                emit(Div);
+            } else {
+                break;
+            }
+        }
+    }
+
+    // unary := ('-' | '+') unary | power
+    void parseUnary() {
+        if (accept('-')) {
+            parseUnary();
+            emit(Neg);
+        } else if (accept('+')) {
+            parseUnary();
+        } else {
+            parsePower();
+        }
+    }
+
+    // power := primary ('^' unary)?
+    void parsePower() {
+        parsePrimary();
+        if (accept('^')) {
+            parseUnary();
+            emit(Pow);
+        }
+    }
+
+    // primary := number | variable | function '(' sum ')' | '(' sum ')'
+    void parsePrimary() {
+        skipSpaces();
+        if (pos == text.size()) {
+            fail("unexpected end of expression");
+        }
+
+        if (accept('(')) {
+            parseSum();
+            if (!accept(')')) {
+                fail("missing ')'");
+            }
+            return;
+        }
+
+        char c = text[pos];
+        if (std::isdigit(static_cast<unsigned char>(c)) || c == '.') {
+            const char* begin = text.c_str() + pos;
+            char* end = nullptr;
+            double value = std::strtod(begin, &end);
+            if (end == begin) {
+                fail("invalid number");
+            }
+            pos += end - begin;
+            emit(PushConst, value);
+            return;
+        }
+
+        if (std::isalpha(static_cast<unsigned char>(c))) {
+            size_t start = pos;
+            while (pos < text.size() && (std::isalnum(static_cast<unsigned char>(text[pos])) || text[pos] == '_')) {
+                pos++;
+            }
+            std::string name = text.substr(start, pos - start);
+            for (size_t i = 0; i < names.size(); ++i) {
+                if (name == names[i]) {
+                    emit(PushVar, 0.0, static_cast<int>(i));
+                    return;
+                }
+            }
+
+            Op op;
+            if (name == "sin") op = Sin;
+            else if (name == "cos") op = Cos;
+            else if (name == "tan") op = Tan;
+            else if (name == "exp") op = Exp;
+            else if (name == "log") op = Log;
+            else if (name == "sqrt") op = Sqrt;
+            else {
+                pos = start;
+                fail("unknown name '" + name + "'");
+            }
+
+            if (!accept('(')) {
+                fail("expected '(' after " + name);
+            }
+            parseSum();
+            if (!accept(')')) {
+                fail("missing ')'");
+            }
+            emit(op);
+            return;
+        }
+
+        fail(std::string("unexpected character '") + c + "'");
+    }
+};
+
+#endif
@@ -2,78 +2,220 @@
 #include <vector>
 #include <cmath>
 #include <iomanip>
+#include <algorithm>
+#include <string>
+#include <stdexcept>
 
-using namespace std;
+#include "batch_io.h"
+#include "iteration_observer.h"
+#include "linear_systems.h"
+#include "sparse_matrix.h"
 
-// Function to perform the Jacobi method
-void jacobi(vector<vector<double>>& A, vector<double>& b, vector<double>& x, int maxIterations, double tolerance) {
-    int n = A.size();
-    vector<double> x_old(n);
-    for (int iteration = 0; iteration <= maxIterations; iteration++) {
-        x_old = x;  // Use the previous iteration values for all updates
+using namespace std;
 
-        for (int i = 0; i < n; i++) {
-            double sum = b[i];
-            for (int j = 0; j < n; j++) {
-                if (i != j) {
-                    sum -= A[i][j] * x_old[j];
+// Batch mode: each record is "method n nnz tolerance omega maxIterations"
+// followed by the nnz nonzero entries of A as "i j value" triplets
+// (1-based, as in Matrix Market files) and the n entries of b, with
+// method 1 = Jacobi, 2 = Gauss-Seidel, 3 = SOR, 4 = red-black SOR and
+// omega <= 0 for the estimated factor. The output line is the number of
+// sweeps (-1 if not converged) followed by x.
+int runBatch(const string& path) {
+    RecordWriter out(cout);
+    try {
+        RecordReader in(path);
+        vector<int> rows, cols;
+        vector<double> values, b, x;
+        IterationObserver observer;
+        while (!in.atEnd()) {
+            int choice = in.integer();
+            int n = in.integer();
+            int nnz = in.integer();
+            double tolerance = in.number();
+            double omega = in.number();
+            int maxIterations = in.integer();
+            if (n <= 0) {
+                in.fail("invalid size");
+            }
+            if (nnz < 0) {
+                in.fail("invalid number of nonzeros");
+            }
+            rows.resize(nnz);
+            cols.resize(nnz);
+            values.resize(nnz);
+            for (int k = 0; k < nnz; k++) {
+                rows[k] = in.integer() - 1;
+                cols[k] = in.integer() - 1;
+                values[k] = in.number();
+                if (rows[k] < 0 || rows[k] >= n || cols[k] < 0 || cols[k] >= n) {
+                    in.fail("matrix entry out of range");
                 }
             }
-            x[i] = sum / A[i][i];
-        }
-
-        // Print the current state of x (including the 0th iteration)
-        cout << "Iteration " << iteration << ": ";
-        for (int i = 0; i < n; i++) {
-            cout << setprecision(6) << fixed << x[i] << " ";
-        }
-        cout << endl;
+            b.resize(n);
+            in.numbers(b.data(), n);
 
-        // Check for convergence if past the 0th iteration
-        if (iteration > 0) {
-            double norm = 0.0;
-            for (int i = 0; i < n; i++) {
-                norm += pow(x[i] - x_old[i], 2);
+            SparseMatrix A(n, n, rows, cols, values);
+            x.assign(n, 0.0);
+            if ((choice == 3 || choice == 4) && omega <= 0.0) {
+                omega = estimateOmega(A);
             }
-            norm = sqrt(norm);
-
-            if (norm < tolerance) {
-                cout << "Converged after " << iteration << " iterations." << endl;
-                return;
+            int sweeps;
+            switch (choice) {
+                case 1:
+                    sweeps = jacobi(A, b, x, maxIterations, tolerance, observer);
+                    break;
+                case 2:
+                    sweeps = gaussSeidel(A, b, x, maxIterations, tolerance, observer);
+                    break;
+                case 3:
+                    sweeps = sor(A, b, x, omega, maxIterations, tolerance, observer);
+                    break;
+                case 4:
+                    sweeps = multicolorSor(A, b, x, omega, maxIterations, tolerance, observer);
+                    break;
+                default:
+                    out.error("Invalid method " + to_string(choice) + ".");
+                    continue;
+            }
+            out.integer(sweeps);
+            for (double value : x) {
+                out.number(value);
             }
+            out.endRecord();
         }
+    } catch (runtime_error &e) {
+        out.flush();
+        cerr << e.what() << endl;
+        return -1;
     }
-    cout << "Reached maximum iterations without converging." << endl;
+    return 0;
 }
 
-int main() {
+int main(int argc, char** argv) {
+    BatchOptions batch;
+    if (batchMode(argc, argv, batch)) {
+        return runBatchMode(batch, runBatch);
+    }
+
     int n;  // Size of the matrix
-    cout << "Enter the size of the matrix (n): ";
+    cout << "Enter the size of the matrix (n), or 0 to read A from a Matrix Market (.mtx) file: ";
     cin >> n;
 
-    vector<vector<double>> A(n, vector<double>(n));
-    vector<double> b(n);
-    vector<double> x(n, 0.0);  // Initial guess (can be zeros)
+    SparseMatrix A;
+    vector<double> b;
+    bool fromFile = (n == 0);
 
-    cout << "Enter the elements of the matrix A row-wise:" << endl;
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            cin >> A[i][j];
+    if (fromFile) {
+        string path;
+        cout << "Enter the path of the .mtx file: ";
+        cin >> path;
+        try {
+            A = readMatrixMarket(path);
+        } catch (runtime_error &e) {
+            cerr << e.what() << endl;
+            return -1;
         }
-    }
+        if (A.rows() != A.cols()) {
+            cerr << "Matrix must be square." << endl;
+            return -1;
+        }
+        n = A.rows();
 
-    cout << "Enter the elements of the vector b:" << endl;
-    for (int i = 0; i < n; i++) {
-        cin >> b[i];
+        // Right-hand side chosen so that the exact solution is x = (1, ..., 1)
+        A.multiply(vector<double>(n, 1.0), b);
+        cout << "Loaded " << n << "x" << n << " matrix with " << A.nonZeros() << " nonzeros, b = A * (1, ..., 1)" << endl;
+    } else {
+        vector<vector<double>> dense(n, vector<double>(n));
+        b.resize(n);
+
+        cout << "Enter the elements of the matrix A row-wise:" << endl;
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++) {
+                cin >> dense[i][j];
+            }
+        }
+
+        cout << "Enter the elements of the vector b:" << endl;
+        for (int i = 0; i < n; i++) {
+            cin >> b[i];
+        }
+
+        A = SparseMatrix::fromDense(dense);
     }
 
+    vector<double> x(n, 0.0);  // Initial guess (can be zeros)
+
     double tolerance;
     cout << "Enter the tolerance value: ";
     cin >> tolerance;
 
     int maxIterations = 100;
 
-    jacobi(A, b, x, maxIterations, tolerance);
+    int choice;
+    cout << "Choose method:\n1. Jacobi\n2. Gauss-Seidel\n3. SOR\n4. Red-black (multicolor) SOR\n";
+    cin >> choice;
+
+    double omega = 1.0;
+    if (choice == 3 || choice == 4) {
+        cout << "Enter the relaxation factor omega (0 for automatic): ";
+        cin >> omega;
+        if (omega <= 0.0) {
+            omega = estimateOmega(A);
+            cout << "Estimated omega = " << setprecision(6) << fixed << omega << endl;
+        }
+    }
+
+    int trace;
+    cout << "Trace mode (0 = off, 1 = every k iterations, 2 = residual history): ";
+    cin >> trace;
+
+    IterationObserver observer;
+    if (trace == 1) {
+        int k;
+        cout << "Print every k-th iteration, k = ";
+        cin >> k;
+        observer = IterationObserver::everyK(k, cout);
+    } else if (trace == 2) {
+        observer = IterationObserver::history(maxIterations);
+    }
+
+    int sweeps = 0;
+    switch (choice) {
+        case 1:
+            sweeps = jacobi(A, b, x, maxIterations, tolerance, observer);
+            break;
+        case 2:
+            sweeps = gaussSeidel(A, b, x, maxIterations, tolerance, observer);
+            break;
+        case 3:
+            sweeps = sor(A, b, x, omega, maxIterations, tolerance, observer);
+            break;
+        case 4:
+            sweeps = multicolorSor(A, b, x, omega, maxIterations, tolerance, observer);
+            break;
+        default:
+            cout << "Invalid choice" << endl;
+            return -1;
+    }
+
+    if (trace == 2) {
+        cout << "Residual history (iteration residual):" << endl;
+        observer.dump(cout);
+    }
+
+    if (sweeps > 0) {
+        cout << "Converged after " << sweeps << " sweeps." << endl;
+    } else {
+        cout << "Reached maximum iterations without converging." << endl;
+    }
+
+    if (fromFile) {
+        double maxError = 0.0;
+        for (int i = 0; i < n; i++) {
+            maxError = max(maxError, fabs(x[i] - 1.0));
+        }
+        cout << "Max error against x = (1, ..., 1): " << scientific << maxError << endl;
+        return 0;
+    }
 
     cout << "Solution: " << endl;
     for (int i = 0; i < n; i++) {
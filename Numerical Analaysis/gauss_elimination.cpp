@@ -2,60 +2,67 @@
 #include <vector>
 #include <iomanip>
 #include <cmath>
+#include <stdexcept>
+#include <string>
+
+#include "batch_io.h"
+#include "dense_matrix.h"
+#include "linear_systems.h"
 
 // Matris ve vektörler için typedef
 typedef std::vector<double> Vector;
-typedef std::vector<Vector> Matrix;
-
-// Gauss eliminasyonu ile üçgenleştirme ve geriye yerine koyma
-Vector gaussElimination(Matrix A, Vector b) {
-    int n = A.size();
+typedef DenseMatrix Matrix;
 
-    // Üçgenleştirme
-    for (int i = 0; i < n; i++) {
-        // Maksimum elemanı bulma
-        int maxRow = i;
-        for (int k = i + 1; k < n; k++) {
-            if (fabs(A[k][i]) > fabs(A[maxRow][i])) {
-                maxRow = k;
+// Batch mode: each record is n followed by the n equations, each given as
+// its n coefficients and the constant term. One output line per record
+// holds x1 ... xn. A and b are kept between records of the same size.
+int runBatch(const std::string& path) {
+    RecordWriter out(std::cout);
+    try {
+        RecordReader in(path);
+        Matrix A;
+        Vector b;
+        while (!in.atEnd()) {
+            int n = in.integer();
+            if (n <= 0) {
+                in.fail("invalid size");
             }
-        }
-
-        // Satır değişimi
-        std::swap(A[maxRow], A[i]);
-        std::swap(b[maxRow], b[i]);
-
-        // Satırları eleminasyon yapma
-        for (int k = i + 1; k < n; k++) {
-            double c = -A[k][i] / A[i][i];
-            for (int j = i; j < n; j++) {
-                if (i == j) {
-                    A[k][j] = 0;
-                } else {
-                    A[k][j] += c * A[i][j];
+            if (A.rows() != n) {
+                A = Matrix(n, n);
+                b.resize(n);
+            }
+            for (int i = 0; i < n; i++) {
+                in.numbers(A.row(i), n);
+                b[i] = in.number();
+            }
+            try {
+                for (double value : gaussElimination(A, b)) {
+                    out.number(value);
                 }
+                out.endRecord();
+            } catch (std::runtime_error& e) {
+                out.error(e.what());
             }
-            b[k] += c * b[i];
         }
+    } catch (std::runtime_error& e) {
+        out.flush();
+        std::cerr << e.what() << std::endl;
+        return -1;
     }
+    return 0;
+}
 
-    // Geriye yerine koyma
-    Vector x(n);
-    for (int i = n - 1; i >= 0; i--) {
-        x[i] = b[i] / A[i][i];
-        for (int k = i - 1; k >= 0; k--) {
-            b[k] -= A[k][i] * x[i];
-        }
+int main(int argc, char** argv) {
+    BatchOptions batch;
+    if (batchMode(argc, argv, batch)) {
+        return runBatchMode(batch, runBatch);
     }
-    return x;
-}
 
-int main() {
     int n;
     std::cout << "Enter the number of variables: ";
     std::cin >> n;
 
-    Matrix A(n, Vector(n));
+    Matrix A(n, n);
     Vector b(n);
 
     std::cout << "Enter the coefficients of the equations:\n";
@@ -63,16 +70,22 @@ int main() {
         std::cout << "Equation " << i + 1 << ":\n";
         for (int j = 0; j < n; j++) {
             std::cout << "Coefficient of x" << j + 1 << ": ";
-            std::cin >> A[i][j];
+            std::cin >> A(i, j);
         }
         std::cout << "Enter the constant term: ";
         std::cin >> b[i];
     }
 
-    Vector result = gaussElimination(A, b);
+    Vector result;
+    try {
+        result = gaussElimination(A, b);
+    } catch (std::runtime_error& e) {
+        std::cerr << e.what() << std::endl;
+        return -1;
+    }
 
     std::cout << "Solution:\n";
-    for (int i = 0; i < result.size(); i++) {
+    for (size_t i = 0; i < result.size(); i++) {
         std::cout << "x" << i + 1 << " = " << result[i] << std::endl;
     }
 
@@ -0,0 +1,84 @@
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+#include "interpolation.h"
+
+using namespace std;
+
+vector<double> forwardDifferences(const vector<double>& y, int n, vector<double>* tail) {
+    vector<double> diff(y.begin(), y.begin() + n);
+    if (tail) {
+        tail->assign(n, 0.0);
+        if (n > 0) {
+            (*tail)[0] = diff[n - 1];
+        }
+    }
+
+    for (int j = 1; j < n; ++j) {
+        for (int i = n - 1; i >= j; --i) {
+            diff[i] -= diff[i - 1];
+        }
+        if (tail) {
+            (*tail)[j] = diff[n - 1];
+        }
+    }
+
+    return diff;
+}
+
+NewtonForward buildNewtonForward(const vector<double>& x, const vector<double>& leading, const vector<double>& tail, int n) {
+    NewtonForward p;
+    p.x0 = x[0];
+    p.h = n > 1 ? x[1] - x[0] : 1.0;
+    p.coefficients.resize(n);
+    p.tail = tail;
+    double inverseFactorial = 1.0;
+    for (int i = 0; i < n; ++i) {
+        if (i > 0) {
+            inverseFactorial /= i;
+        }
+        p.coefficients[i] = leading[i] * inverseFactorial;
+    }
+    p.inverseFactorial = inverseFactorial;
+    return p;
+}
+
+void appendSample(NewtonForward& p, double x, double y) {
+    int n = p.coefficients.size();
+    if (n == 1) {
+        p.h = x - p.x0;
+    }
+    double expected = p.x0 + n * p.h;
+    if (n == 0 || p.h == 0.0 || fabs(x - expected) > 1e-9 * fabs(p.h) * max(1, n)) {
+        throw runtime_error("Appended samples must continue the equally spaced grid.");
+    }
+
+    double previous = p.tail[0];
+    p.tail[0] = y;
+    for (int j = 1; j < n; ++j) {
+        double current = p.tail[j];
+        p.tail[j] = p.tail[j - 1] - previous;
+        previous = current;
+    }
+    p.tail.push_back(p.tail[n - 1] - previous);
+
+    p.inverseFactorial /= n;
+    p.coefficients.push_back(p.tail[n] * p.inverseFactorial);
+}
+
+void newtonForwardInterpolationBatch(const NewtonForward& p, const double* values, double* results, size_t count) {
+    const double* c = p.coefficients.data();
+    int n = p.coefficients.size();
+    double x0 = p.x0, inverseH = 1.0 / p.h;
+    #pragma omp parallel for simd schedule(static)
+    for (size_t k = 0; k < count; ++k) {
+        double u = (values[k] - x0) * inverseH;
+        double result = c[n - 1];
+        for (int i = n - 1; i > 0; --i) {
+            result = c[i - 1] + (u - (i - 1)) * result;
+        }
+        results[k] = result;
+    }
+}
@@ -0,0 +1,171 @@
+#ifndef INTERPOLATION_H
+#define INTERPOLATION_H
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Newton forward polynomial in nested form, built once from the differences.
+// coefficients[i] = delta^i y0 / i!, so that with u = (x - x0) / h
+//   p(u) = c0 + u (c1 + (u - 1) (c2 + (u - 2) (c3 + ...)))
+// tail holds the last diagonal of the difference table so that new samples
+// can be appended in O(n) without rebuilding.
+struct NewtonForward {
+    double x0;
+    double h;
+    std::vector<double> coefficients;
+    std::vector<double> tail;
+    double inverseFactorial;  // 1 / (n-1)! for the current number of samples
+};
+
+// Function to calculate the forward differences.
+// Only the leading differences delta^i y0 are needed, so they are computed
+// in place in one vector of length n instead of a full n x n table.
+// If tail is given, it receives the last diagonal of the table,
+// tail[j] = delta^j y[n-1-j], which is what appending a sample needs.
+std::vector<double> forwardDifferences(const std::vector<double>& y, int n, std::vector<double>* tail = nullptr);
+
+// Fold the 1/i! factors into the leading differences (computed in double,
+// so there is no integer factorial to overflow)
+NewtonForward buildNewtonForward(const std::vector<double>& x, const std::vector<double>& leading, const std::vector<double>& tail, int n);
+
+// Append a sample at the next grid point x0 + n * h (e.g. from a sensor
+// stream). The last diagonal is updated in O(n) and yields the one new
+// leading difference; the existing coefficients do not change.
+void appendSample(NewtonForward& p, double x, double y);
+
+// Evaluate many query points at once. The queries are independent, so the
+// loop is vectorized across queries and split across threads with OpenMP.
+void newtonForwardInterpolationBatch(const NewtonForward& p, const double* values, double* results, std::size_t count);
+
+// Function to perform Newton's forward interpolation: O(n) Horner-like evaluation
+inline double newtonForwardInterpolation(const NewtonForward& p, double value) {
+    const double* c = p.coefficients.data();
+    int n = p.coefficients.size();
+    double u = (value - p.x0) / p.h;
+    double result = c[n - 1];
+    for (int i = n - 1; i > 0; --i) {
+        result = c[i - 1] + (u - (i - 1)) * result;
+    }
+    return result;
+}
+
+// Local interpolation index for large, possibly non-uniform tables.
+// The x-grid is kept sorted; a query finds its interval by interpolation
+// search and evaluates the Newton divided-difference polynomial of degree k
+// through the k + 1 grid points around it. The divided differences of every
+// window are computed once when the index is built, so a query costs
+// O(log n + k) (O(1 + k) on near-uniform grids).
+class InterpolationIndex {
+public:
+    InterpolationIndex(std::vector<double> x, std::vector<double> y, int degree) : k(degree) {
+        int n = x.size();
+        if (k < 0 || k + 1 > n) {
+            throw std::runtime_error("The degree must be between 0 and the number of points - 1.");
+        }
+
+        // Sort the samples by x if necessary
+        if (!std::is_sorted(x.begin(), x.end())) {
+            std::vector<int> order(n);
+            for (int i = 0; i < n; ++i) {
+                order[i] = i;
+            }
+            std::sort(order.begin(), order.end(), [&x](int a, int b) { return x[a] < x[b]; });
+            std::vector<double> xs(n), ys(n);
+            for (int i = 0; i < n; ++i) {
+                xs[i] = x[order[i]];
+                ys[i] = y[order[i]];
+            }
+            x.swap(xs);
+            y.swap(ys);
+        }
+        for (int i = 1; i < n; ++i) {
+            if (x[i] == x[i - 1]) {
+                throw std::runtime_error("The x values must be distinct.");
+            }
+        }
+        grid = std::move(x);
+
+        // Divided differences of each window [s, s + k], stored contiguously
+        int windows = n - k;
+        coefficients.resize(static_cast<size_t>(windows) * (k + 1));
+        #pragma omp parallel for schedule(static)
+        for (int s = 0; s < windows; ++s) {
+            double* c = &coefficients[static_cast<size_t>(s) * (k + 1)];
+            for (int j = 0; j <= k; ++j) {
+                c[j] = y[s + j];
+            }
+            for (int order = 1; order <= k; ++order) {
+                for (int j = k; j >= order; --j) {
+                    c[j] = (c[j] - c[j - 1]) / (grid[s + j] - grid[s + j - order]);
+                }
+            }
+        }
+    }
+
+    double operator()(double value) const {
+        int n = grid.size();
+        int i = findInterval(value);                          // grid[i] <= value < grid[i + 1]
+        int s = std::min(std::max(i - k / 2, 0), n - k - 1);  // window centred on the interval
+        const double* c = &coefficients[static_cast<size_t>(s) * (k + 1)];
+        const double* xs = &grid[s];
+        double result = c[k];
+        for (int j = k - 1; j >= 0; --j) {
+            result = c[j] + (value - xs[j]) * result;
+        }
+        return result;
+    }
+
+    void evaluateBatch(const double* values, double* results, std::size_t count) const {
+        #pragma omp parallel for schedule(static)
+        for (std::size_t q = 0; q < count; ++q) {
+            results[q] = (*this)(values[q]);
+        }
+    }
+
+private:
+    int k;
+    std::vector<double> grid;
+    std::vector<double> coefficients;
+
+    // Index i of the interval containing value, clamped to [0, n - 2]
+    int findInterval(double value) const {
+        int n = grid.size();
+        if (n < 2 || value <= grid[0]) {
+            return 0;
+        }
+        if (value >= grid[n - 1]) {
+            return n - 2;
+        }
+
+        // Interpolation guess, then widen the bracket around it and bisect
+        int guess = static_cast<int>((value - grid[0]) / (grid[n - 1] - grid[0]) * (n - 1));
+        guess = std::min(std::max(guess, 0), n - 2);
+        int lo = guess, hi = guess + 1;
+        int step = 1;
+        while (lo > 0 && grid[lo] > value) {
+            hi = lo;
+            lo = std::max(lo - step, 0);
+            step *= 2;
+        }
+        step = 1;
+        while (hi < n - 1 && grid[hi] <= value) {
+            lo = hi;
+            hi = std::min(hi + step, n - 1);
+            step *= 2;
+        }
+        while (hi - lo > 1) {
+            int mid = lo + (hi - lo) / 2;
+            if (grid[mid] <= value) {
+                lo = mid;
+            } else {
+                hi = mid;
+            }
+        }
+        return lo;
+    }
+};
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef ITERATION_OBSERVER_H
+#define ITERATION_OBSERVER_H
+
+#include <atomic>
+#include <cstddef>
+#include <iomanip>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+// Receives the residual of every iteration of an iterative solver.
+// Solvers call record() once per iteration and never do I/O themselves.
+//
+//   Off      - record() returns immediately
+//   EveryK   - every k-th iteration is printed to the given stream
+//   History  - residuals go into a fixed-size ring buffer that keeps the
+//              most recent entries and can be dumped after the solve
+//
+// The ring buffer claims slots with an atomic counter, so recording is
+// lock-free and never allocates.
+class IterationObserver {
+public:
+    enum Mode { Off, EveryK, History };
+
+    struct Sample {
+        int iteration;
+        double residual;
+    };
+
+    IterationObserver() : mode(Off), interval(1), out(nullptr), written(0) {}
+
+    static IterationObserver everyK(int k, std::ostream& stream) {
+        IterationObserver observer;
+        observer.mode = EveryK;
+        observer.interval = k > 0 ? k : 1;
+        observer.out = &stream;
+        return observer;
+    }
+
+    static IterationObserver history(size_t capacity) {
+        IterationObserver observer;
+        observer.mode = History;
+        observer.ring.resize(capacity > 0 ? capacity : 1);
+        return observer;
+    }
+
+    IterationObserver(IterationObserver&& other)
+        : mode(other.mode), interval(other.interval), out(other.out),
+          ring(std::move(other.ring)), written(other.written.load()) {}
+
+    IterationObserver& operator=(IterationObserver&& other) {
+        mode = other.mode;
+        interval = other.interval;
+        out = other.out;
+        ring = std::move(other.ring);
+        written.store(other.written.load());
+        return *this;
+    }
+
+    void record(int iteration, double residual) {
+        if (mode == Off) {
+            return;
+        }
+        if (mode == EveryK) {
+            if (iteration % interval == 0) {
+                *out << "Iteration " << iteration << ": residual = "
+                     << std::scientific << std::setprecision(6) << residual << '\n';
+            }
+            return;
+        }
+        size_t slot = written.fetch_add(1, std::memory_order_relaxed);
+        ring[slot % ring.size()] = {iteration, residual};
+    }
+
+    // Recorded history, oldest first (only the last capacity entries are kept)
+    std::vector<Sample> samples() const {
+        size_t total = written.load(std::memory_order_acquire);
+        size_t capacity = ring.size();
+        size_t count = total < capacity ? total : capacity;
+        std::vector<Sample> result;
+        result.reserve(count);
+        for (size_t k = total - count; k < total; ++k) {
+            result.push_back(ring[k % capacity]);
+        }
+        return result;
+    }
+
+    void dump(std::ostream& stream) const {
+        for (const Sample& s : samples()) {
+            stream << s.iteration << ' ' << std::scientific << std::setprecision(6) << s.residual << '\n';
+        }
+    }
+
+private:
+    Mode mode;
+    int interval;
+    std::ostream* out;
+    std::vector<Sample> ring;
+    std::atomic<size_t> written;
+};
+
+#endif
@@ -1,47 +1,160 @@
 #include <iostream>
 #include <cmath>
 #include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+
+#include "batch_io.h"
+#include "cubic_roots.h"
 
 using namespace std;
 
-// Function to evaluate the given function f(x) = ax^3 + bx^2 + cx + d
-double f(double a, double b, double c, double d, double x) {
-    return a * pow(x, 3) + b * pow(x, 2) + c * x + d;
+// Read coefficient quadruples "a b c d" into arrays with the batch-mode
+// reader, so '#' comments work and malformed input throws
+// std::runtime_error with its line number
+void readCoefficients(const string& path, vector<double>& a, vector<double>& b, vector<double>& c, vector<double>& d) {
+    RecordReader in(path);
+    while (!in.atEnd()) {
+        a.push_back(in.number());
+        b.push_back(in.number());
+        c.push_back(in.number());
+        d.push_back(in.number());
+    }
 }
 
-// Function to check if the function has a root in the interval (a, b)
-bool hasRoot(double a, double b, double c, double d, double lowerBound, double upperBound) {
-    return f(a, b, c, d, lowerBound) * f(a, b, c, d, upperBound) < 0;
+// Deterministic cubics x^3 + b x^2 + c x + d with a root in (-1, 1)
+void randomCubics(size_t count, vector<double>& a, vector<double>& b, vector<double>& c, vector<double>& d) {
+    a.assign(count, 1.0);
+    b.resize(count);
+    c.resize(count);
+    d.resize(count);
+    unsigned long long state = 0x9E3779B97F4A7C15ULL;
+    auto uniform = [&state]() {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<double>(state >> 11) / 9007199254740992.0 * 2.0 - 1.0;
+    };
+    for (size_t i = 0; i < count; ++i) {
+        double r = uniform();
+        b[i] = 4.0 * uniform();
+        c[i] = 4.0 * uniform();
+        d[i] = -cubic(1.0, b[i], c[i], 0.0, r);
+    }
 }
 
-// Bisection method to find the root
-double bisection(double a, double b, double c, double d, double lowerBound, double upperBound, double epsilon) {
-    if (!hasRoot(a, b, c, d, lowerBound, upperBound)) {
-        cerr << "The function does not have a root in the given interval." << endl;
-        return NAN;
-    }
-
-    double left = lowerBound;
-    double right = upperBound;
-    double middle;
-    while ((right - left) / 2 > epsilon) {
-        middle = (left + right) / 2;
-        if (f(a, b, c, d, middle) == 0) {
-            return middle;
-        } else if (f(a, b, c, d, middle) * f(a, b, c, d, left) < 0) {
-            right = middle;
-        } else {
-            left = middle;
+// Batch mode: each record is "a b c d lower upper epsilon", one root per
+// output line (nan when the ends do not bracket a root, an error line when
+// epsilon is not positive). Records are read in blocks that go through
+// bisectionBatch together, each with its own epsilon; the block arrays are
+// reused.
+int runBatch(const string& path) {
+    const size_t Block = 1 << 16;
+    vector<double> a(Block), b(Block), c(Block), d(Block), lower(Block), upper(Block), epsilon(Block), roots(Block);
+    vector<char> valid(Block);
+    RecordWriter out(cout);
+    try {
+        RecordReader in(path);
+        while (!in.atEnd()) {
+            size_t count = 0;
+            for (; count < Block && !in.atEnd(); ++count) {
+                a[count] = in.number();
+                b[count] = in.number();
+                c[count] = in.number();
+                d[count] = in.number();
+                lower[count] = in.number();
+                upper[count] = in.number();
+                epsilon[count] = in.number();
+                valid[count] = epsilon[count] > 0;
+                if (!valid[count]) {
+                    // Keep the lane but give it no bracket to work on
+                    lower[count] = upper[count] = 0.0;
+                    epsilon[count] = 1.0;
+                }
+            }
+            bisectionBatch(a.data(), b.data(), c.data(), d.data(), lower.data(), upper.data(), roots.data(), count,
+                           epsilon.data());
+            for (size_t i = 0; i < count; ++i) {
+                if (!valid[i]) {
+                    out.error("Epsilon must be positive.");
+                    continue;
+                }
+                out.number(roots[i]);
+                out.endRecord();
+            }
         }
+    } catch (runtime_error& e) {
+        out.flush();
+        cerr << e.what() << endl;
+        return -1;
     }
-
-    return (left + right) / 2;
+    return 0;
 }
 
-int main() {
+int main(int argc, char** argv) {
+    BatchOptions batch;
+    if (batchMode(argc, argv, batch)) {
+        return runBatchMode(batch, runBatch);
+    }
+
+    int mode;
+    cout << "Choose mode:\n1. Single polynomial\n2. Batch (coefficient file)\n3. Batch throughput benchmark\n4. All roots in interval\n";
+    cin >> mode;
+
+    if (mode == 2 || mode == 3) {
+        vector<double> a, b, c, d;
+        string output = "-";
+        if (mode == 2) {
+            string path;
+            cout << "Enter the coefficient file (one \"a b c d\" per line): ";
+            cin >> path;
+            try {
+                readCoefficients(path, a, b, c, d);
+            } catch (runtime_error& e) {
+                cerr << e.what() << endl;
+                return -1;
+            }
+            cout << "Enter the output file for the roots (- to skip): ";
+            cin >> output;
+        } else {
+            size_t count;
+            cout << "Enter the number of cubics: ";
+            cin >> count;
+            randomCubics(count, a, b, c, d);
+        }
+
+        double lowerBound, upperBound, epsilon;
+        cout << "Enter the lower and upper bounds of the interval: ";
+        cin >> lowerBound >> upperBound;
+        cout << "Enter the epsilon value: ";
+        cin >> epsilon;
+
+        size_t count = a.size();
+        vector<double> lower(count, lowerBound), upper(count, upperBound), roots(count);
+        auto begin = chrono::steady_clock::now();
+        size_t found = bisectionBatch(a.data(), b.data(), c.data(), d.data(), lower.data(), upper.data(), roots.data(), count, epsilon);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+
+        cout << "Roots found: " << found << " of " << count << endl;
+        cout << "Time: " << seconds << " s, throughput: " << count / seconds << " roots/s" << endl;
+
+        if (output != "-") {
+            ofstream out(output);
+            if (!out) {
+                cerr << "Cannot open " << output << endl;
+                return -1;
+            }
+            out << setprecision(17);
+            for (double root : roots) {
+                out << root << '\n';
+            }
+        }
+        return 0;
+    }
+
     double a, b, c, d;
     double lowerBound, upperBound;
-    double epsilon;
 
     cout << "Enter the coefficients of the polynomial (a, b, c, d): ";
     cin >> a >> b >> c >> d;
@@ -49,15 +162,40 @@ int main() {
     cout << "Enter the lower and upper bounds of the interval: ";
     cin >> lowerBound >> upperBound;
 
-    cout << "Enter the epsilon value: ";
-    cin >> epsilon;
+    if (mode == 4) {
+        double epsilon;
+        cout << "Enter the epsilon value: ";
+        cin >> epsilon;
 
-    if (hasRoot(a, b, c, d, lowerBound, upperBound)) {
-        double root = bisection(a, b, c, d, lowerBound, upperBound, epsilon);
-        cout << "Root found: x = " << setprecision(10) << root << endl;
-    } else {
+        size_t subintervals;
+        cout << "Enter the number of scan subintervals: ";
+        cin >> subintervals;
+
+        vector<double> roots = cubicRoots(a, b, c, d, lowerBound, upperBound);
+        cout << "Closed form: " << roots.size() << " root(s)" << endl;
+        for (double root : roots) {
+            cout << "  x = " << setprecision(10) << root << endl;
+        }
+
+        auto polynomial = [=](double x) { return cubic(a, b, c, d, x); };
+        vector<double> scanned = scanRoots(polynomial, lowerBound, upperBound, max<size_t>(subintervals, 1), epsilon);
+        cout << "Sign-change scan: " << scanned.size() << " root(s)" << endl;
+        for (double root : scanned) {
+            cout << "  x = " << setprecision(10) << root << endl;
+        }
+        return 0;
+    }
+
+    // A sign change at the ends only proves an odd number of roots and its
+    // absence does not rule out two roots or a double root, so every root
+    // in the interval comes from the closed form
+    vector<double> roots = cubicRoots(a, b, c, d, lowerBound, upperBound);
+    if (roots.empty()) {
         cout << "The function does not have a root in the interval (" << lowerBound << ", " << upperBound << ")." << endl;
     }
+    for (double root : roots) {
+        cout << "Root found: x = " << setprecision(10) << root << endl;
+    }
 
     return 0;
 }
@@ -0,0 +1,187 @@
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#include "linear_systems.h"
+#include "lu.h"
+#include "solver_stats.h"
+
+using namespace std;
+
+vector<double> gaussElimination(const DenseMatrix& A, const vector<double>& b) {
+    SolveTimer timer("gauss_elimination");
+    LUFactorization lu(A);
+    vector<double> x = lu.solve(b);
+    timer.finish(0, 0, NAN);
+    return x;
+}
+
+int jacobi(const SparseMatrix& A, const vector<double>& b, vector<double>& x, int maxIterations, double tolerance, IterationObserver& observer) {
+    int n = A.rows();
+    const vector<int>& rowStart = A.rowPointers();
+    const vector<int>& col = A.columns();
+    const vector<double>& val = A.entries();
+    vector<double> diag = A.diagonal();
+    vector<double> x_old(n);
+    SolveTimer timer("jacobi");
+    double norm = NAN;
+    for (int iteration = 1; iteration <= maxIterations; iteration++) {
+        x_old.swap(x);  // Use the previous iteration values for all updates
+
+        norm = 0.0;
+        #pragma omp parallel for reduction(+:norm) schedule(static)
+        for (int i = 0; i < n; i++) {
+            double sum = b[i];
+            for (int k = rowStart[i]; k < rowStart[i + 1]; k++) {
+                sum -= val[k] * x_old[col[k]];
+            }
+            x[i] = (sum + diag[i] * x_old[i]) / diag[i];
+            double d = x[i] - x_old[i];
+            norm += d * d;
+        }
+        norm = sqrt(norm);
+        observer.record(iteration, norm);
+
+        if (norm < tolerance) {
+            timer.finish(iteration, iteration, norm);
+            return iteration;
+        }
+    }
+    timer.finish(maxIterations, maxIterations, norm);
+    return -1;
+}
+
+double sorSweep(const SparseMatrix& A, const vector<double>& diag, const vector<double>& b, vector<double>& x, double omega) {
+    int n = A.rows();
+    const vector<int>& rowStart = A.rowPointers();
+    const vector<int>& col = A.columns();
+    const vector<double>& val = A.entries();
+    double change = 0.0;
+    for (int i = 0; i < n; i++) {
+        double sum = b[i];
+        for (int k = rowStart[i]; k < rowStart[i + 1]; k++) {
+            sum -= val[k] * x[col[k]];
+        }
+        double delta = omega * sum / diag[i];
+        x[i] += delta;
+        change += delta * delta;
+    }
+    return change;
+}
+
+int sor(const SparseMatrix& A, const vector<double>& b, vector<double>& x, double omega, int maxIterations, double tolerance, IterationObserver& observer) {
+    vector<double> diag = A.diagonal();
+    SolveTimer timer(omega == 1.0 ? "gauss_seidel" : "sor");
+    double norm = NAN;
+    for (int sweep = 1; sweep <= maxIterations; sweep++) {
+        norm = sqrt(sorSweep(A, diag, b, x, omega));
+        observer.record(sweep, norm);
+        if (norm < tolerance) {
+            timer.finish(sweep, sweep, norm);
+            return sweep;
+        }
+    }
+    timer.finish(maxIterations, maxIterations, norm);
+    return -1;
+}
+
+int gaussSeidel(const SparseMatrix& A, const vector<double>& b, vector<double>& x, int maxIterations, double tolerance, IterationObserver& observer) {
+    return sor(A, b, x, 1.0, maxIterations, tolerance, observer);
+}
+
+double estimateOmega(const SparseMatrix& A, int steps) {
+    int n = A.rows();
+    vector<double> diag = A.diagonal();
+    vector<double> v(n, 1.0), w(n);
+    double rho = 0.0;
+    for (int step = 0; step < steps; step++) {
+        A.multiply(v, w);
+        double norm = 0.0;
+        for (int i = 0; i < n; i++) {
+            w[i] = (w[i] - diag[i] * v[i]) / diag[i];
+            norm += w[i] * w[i];
+        }
+        norm = sqrt(norm);
+        if (norm == 0.0) {
+            return 1.0;
+        }
+        rho = norm / sqrt(n);
+        for (int i = 0; i < n; i++) {
+            v[i] = w[i] / norm * sqrt(n);
+        }
+    }
+    if (rho >= 1.0) {
+        return 1.0;  // Jacobi diverges, over-relaxation is not safe
+    }
+    return 2.0 / (1.0 + sqrt(1.0 - rho * rho));
+}
+
+vector<vector<int>> colorUnknowns(const SparseMatrix& A) {
+    int n = A.rows();
+    const SparseMatrix At = A.transposed();
+    vector<int> color(n, -1);
+    vector<int> usedBy;  // usedBy[c] == i when color c is taken by a neighbour of i
+    int colorCount = 0;
+    for (int i = 0; i < n; i++) {
+        for (const SparseMatrix* M : {&A, &At}) {
+            const vector<int>& rowStart = M->rowPointers();
+            const vector<int>& col = M->columns();
+            for (int k = rowStart[i]; k < rowStart[i + 1]; k++) {
+                int c = color[col[k]];
+                if (c >= 0) {
+                    usedBy[c] = i;
+                }
+            }
+        }
+        int c = 0;
+        while (c < colorCount && usedBy[c] == i) {
+            c++;
+        }
+        if (c == colorCount) {
+            colorCount++;
+            usedBy.push_back(-1);
+        }
+        color[i] = c;
+    }
+
+    vector<vector<int>> groups(colorCount);
+    for (int i = 0; i < n; i++) {
+        groups[color[i]].push_back(i);
+    }
+    return groups;
+}
+
+int multicolorSor(const SparseMatrix& A, const vector<double>& b, vector<double>& x, double omega, int maxIterations, double tolerance, IterationObserver& observer) {
+    vector<vector<int>> groups = colorUnknowns(A);
+    vector<double> diag = A.diagonal();
+    const vector<int>& rowStart = A.rowPointers();
+    const vector<int>& col = A.columns();
+    const vector<double>& val = A.entries();
+    SolveTimer timer("multicolor_sor");
+    double norm = NAN;
+    for (int sweep = 1; sweep <= maxIterations; sweep++) {
+        double change = 0.0;
+        for (const vector<int>& group : groups) {
+            int count = group.size();
+            #pragma omp parallel for reduction(+:change) schedule(static)
+            for (int k = 0; k < count; k++) {
+                int i = group[k];
+                double sum = b[i];
+                for (int p = rowStart[i]; p < rowStart[i + 1]; p++) {
+                    sum -= val[p] * x[col[p]];
+                }
+                double delta = omega * sum / diag[i];
+                x[i] += delta;
+                change += delta * delta;
+            }
+        }
+        norm = sqrt(change);
+        observer.record(sweep, norm);
+        if (norm < tolerance) {
+            timer.finish(sweep, sweep, norm);
+            return sweep;
+        }
+    }
+    timer.finish(maxIterations, maxIterations, norm);
+    return -1;
+}
@@ -0,0 +1,48 @@
+#ifndef LINEAR_SYSTEMS_H
+#define LINEAR_SYSTEMS_H
+
+#include <vector>
+
+#include "dense_matrix.h"
+#include "iteration_observer.h"
+#include "sparse_matrix.h"
+
+// Gauss eliminasyonu (kısmi pivotlamalı LU) ile tek bir sistemi çözme.
+// Aynı A ile birden çok sistem çözülecekse LUFactorization bir kez kurulup
+// solve() tekrar tekrar çağrılmalıdır.
+std::vector<double> gaussElimination(const DenseMatrix& A, const std::vector<double>& b);
+
+// Function to perform the Jacobi method on a CSR matrix.
+// Each sweep costs O(nonzeros); rows are split across threads with OpenMP.
+// The residual of every sweep goes to the observer; the loop does no I/O.
+// Returns the number of sweeps to convergence, or -1 if it did not converge.
+int jacobi(const SparseMatrix& A, const std::vector<double>& b, std::vector<double>& x, int maxIterations, double tolerance, IterationObserver& observer);
+
+// Gauss-Seidel sweep performed in place: each x[i] is updated using the
+// newest values of the other unknowns, so no copy of x is kept.
+// omega = 1 gives plain Gauss-Seidel, 1 < omega < 2 over-relaxes (SOR).
+// Returns the squared norm of the change made during the sweep.
+double sorSweep(const SparseMatrix& A, const std::vector<double>& diag, const std::vector<double>& b, std::vector<double>& x, double omega);
+
+// Function to perform the Gauss-Seidel / SOR method.
+// Returns the number of sweeps to convergence, or -1 if it did not converge.
+int sor(const SparseMatrix& A, const std::vector<double>& b, std::vector<double>& x, double omega, int maxIterations, double tolerance, IterationObserver& observer);
+
+int gaussSeidel(const SparseMatrix& A, const std::vector<double>& b, std::vector<double>& x, int maxIterations, double tolerance, IterationObserver& observer);
+
+// Estimate the optimal SOR factor from the spectral radius rho of the Jacobi
+// iteration matrix D^-1 (L + U), found with a few power iteration steps:
+// omega = 2 / (1 + sqrt(1 - rho^2)).
+double estimateOmega(const SparseMatrix& A, int steps = 50);
+
+// Split the unknowns into colors so that no two unknowns of the same color
+// are coupled through A (greedy graph coloring). For 2D and 3D stencils this
+// gives the classic red-black ordering.
+std::vector<std::vector<int>> colorUnknowns(const SparseMatrix& A);
+
+// Red-black (multicolor) SOR: the unknowns of one color do not depend on each
+// other, so each color is updated in parallel before moving to the next.
+// Returns the number of sweeps to convergence, or -1 if it did not converge.
+int multicolorSor(const SparseMatrix& A, const std::vector<double>& b, std::vector<double>& x, double omega, int maxIterations, double tolerance, IterationObserver& observer);
+
+#endif
@@ -0,0 +1,155 @@
+#ifndef LU_H
+#define LU_H
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "dense_matrix.h"
+
+// LU factorization with partial pivoting, PA = LU.
+// The matrix is factored once in the constructor; solve() can then be
+// called any number of times at O(n^2) cost per right-hand side.
+//
+// The factorization is blocked and right-looking: a panel of BlockSize
+// columns is factored, the matching block row of U is formed, and the
+// trailing matrix is updated with a tiled rank-BlockSize product. The
+// trailing update is split across threads when built with OpenMP.
+class LUFactorization {
+public:
+    static const int BlockSize = 64;
+
+    explicit LUFactorization(DenseMatrix A) : LU(std::move(A)), n(LU.rows()), pivots(n), sign(1) {
+        if (LU.rows() != LU.cols()) {
+            throw std::runtime_error("Matrix must be square.");
+        }
+        for (int k0 = 0; k0 < n; k0 += BlockSize) {
+            int k1 = std::min(k0 + BlockSize, n);
+            factorPanel(k0, k1);
+            solveBlockRow(k0, k1);
+            updateTrailing(k0, k1);
+        }
+    }
+
+    int size() const { return n; }
+
+    // Solve Ax = b in place: b is overwritten with x
+    void solveInPlace(std::vector<double>& b) const {
+        for (int i = 0; i < n; ++i) {
+            if (pivots[i] != i) {
+                std::swap(b[i], b[pivots[i]]);
+            }
+        }
+
+        // Forward substitution with unit lower triangle
+        for (int i = 1; i < n; ++i) {
+            const double* Li = LU.row(i);
+            double sum = b[i];
+            for (int j = 0; j < i; ++j) {
+                sum -= Li[j] * b[j];
+            }
+            b[i] = sum;
+        }
+
+        // Back substitution with upper triangle
+        for (int i = n - 1; i >= 0; --i) {
+            const double* Ui = LU.row(i);
+            double sum = b[i];
+            for (int j = i + 1; j < n; ++j) {
+                sum -= Ui[j] * b[j];
+            }
+            b[i] = sum / Ui[i];
+        }
+    }
+
+    std::vector<double> solve(std::vector<double> b) const {
+        solveInPlace(b);
+        return b;
+    }
+
+    double determinant() const {
+        double det = sign;
+        for (int i = 0; i < n; ++i) {
+            det *= LU(i, i);
+        }
+        return det;
+    }
+
+    // Combined factors: strictly lower part is L (unit diagonal), the rest is U
+    const DenseMatrix& factors() const { return LU; }
+
+private:
+    DenseMatrix LU;
+    int n;
+    std::vector<int> pivots;
+    int sign;
+
+    // Unblocked factorization of columns [k0, k1), pivoting whole rows
+    void factorPanel(int k0, int k1) {
+        for (int j = k0; j < k1; ++j) {
+            int pivot = j;
+            for (int i = j + 1; i < n; ++i) {
+                if (std::fabs(LU(i, j)) > std::fabs(LU(pivot, j))) {
+                    pivot = i;
+                }
+            }
+            if (LU(pivot, j) == 0.0) {
+                throw std::runtime_error("Matrix is singular.");
+            }
+
+            pivots[j] = pivot;
+            if (pivot != j) {
+                std::swap_ranges(LU.row(j), LU.row(j) + n, LU.row(pivot));
+                sign = -sign;
+            }
+
+            const double* Uj = LU.row(j);
+            double inv = 1.0 / Uj[j];
+            for (int i = j + 1; i < n; ++i) {
+                double* Ai = LU.row(i);
+                double l = Ai[j] * inv;
+                Ai[j] = l;
+                for (int c = j + 1; c < k1; ++c) {
+                    Ai[c] -= l * Uj[c];
+                }
+            }
+        }
+    }
+
+    // U12 = L11^-1 * A12 for the block row to the right of the panel
+    void solveBlockRow(int k0, int k1) {
+        for (int j = k0; j < k1; ++j) {
+            const double* Uj = LU.row(j);
+            for (int i = j + 1; i < k1; ++i) {
+                double* Ai = LU.row(i);
+                double l = Ai[j];
+                for (int c = k1; c < n; ++c) {
+                    Ai[c] -= l * Uj[c];
+                }
+            }
+        }
+    }
+
+    // A22 -= L21 * U12, tiled over columns so the U12 tile stays in cache
+    void updateTrailing(int k0, int k1) {
+        const int tile = 4 * BlockSize;
+        for (int c0 = k1; c0 < n; c0 += tile) {
+            int c1 = std::min(c0 + tile, n);
+            #pragma omp parallel for schedule(static)
+            for (int i = k1; i < n; ++i) {
+                double* Ai = LU.row(i);
+                for (int k = k0; k < k1; ++k) {
+                    double l = Ai[k];
+                    const double* Uk = LU.row(k);
+                    for (int c = c0; c < c1; ++c) {
+                        Ai[c] -= l * Uk[c];
+                    }
+                }
+            }
+        }
+    }
+};
+
+#endif
@@ -1,50 +1,77 @@
 #include <iostream>
 #include <vector>
 #include <iomanip> // for std::setprecision
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include <memory>
 
-using namespace std;
+#include "batch_io.h"
+#include "interpolation.h"
 
-// Function to calculate the forward differences
-vector<vector<double>> forwardDifferences(const vector<double>& y, int n) {
-    vector<vector<double>> diffTable(n, vector<double>(n));
-    for (int i = 0; i < n; ++i) {
-        diffTable[i][0] = y[i];
-    }
+using namespace std;
 
-    for (int j = 1; j < n; ++j) {
-        for (int i = 0; i < n - j; ++i) {
-            diffTable[i][j] = diffTable[i + 1][j - 1] - diffTable[i][j - 1];
+// Batch mode: each record is "method n x1..xn y1..yn m q1..qm", with the
+// degree of the local polynomials after n for method 2 ("2 degree n ...").
+// The output line holds f(q1) ... f(qm).
+int runBatch(const string& path) {
+    RecordWriter out(cout);
+    try {
+        RecordReader in(path);
+        vector<double> x, y, values, results;
+        while (!in.atEnd()) {
+            int choice = in.integer();
+            int degree = choice == 2 ? in.integer() : 0;
+            long n = in.integer();
+            if (n <= 0) {
+                in.fail("invalid number of data points");
+            }
+            x.resize(n);
+            y.resize(n);
+            in.numbers(x.data(), n);
+            in.numbers(y.data(), n);
+            long m = in.integer();
+            if (m < 0) {
+                in.fail("invalid number of values");
+            }
+            values.resize(m);
+            results.resize(m);
+            in.numbers(values.data(), m);
+
+            try {
+                if (choice == 2) {
+                    InterpolationIndex index(x, y, degree);
+                    index.evaluateBatch(values.data(), results.data(), m);
+                } else if (choice == 1) {
+                    vector<double> tail;
+                    vector<double> leading = forwardDifferences(y, n, &tail);
+                    NewtonForward polynomial = buildNewtonForward(x, leading, tail, n);
+                    newtonForwardInterpolationBatch(polynomial, values.data(), results.data(), m);
+                } else {
+                    throw runtime_error("Invalid method " + to_string(choice) + ".");
+                }
+                for (long i = 0; i < m; ++i) {
+                    out.number(results[i]);
+                }
+                out.endRecord();
+            } catch (runtime_error& e) {
+                out.error(e.what());
+            }
         }
+    } catch (runtime_error& e) {
+        out.flush();
+        cerr << e.what() << endl;
+        return -1;
     }
-
-    return diffTable;
-}
-
-// Function to calculate the factorial of a number
-int factorial(int n) {
-    int fact = 1;
-    for (int i = 2; i <= n; ++i) {
-        fact *= i;
-    }
-    return fact;
+    return 0;
 }
 
-// Function to perform Newton's forward interpolation
-double newtonForwardInterpolation(const vector<double>& x, const vector<vector<double>>& diffTable, double value, int n) {
-    double result = diffTable[0][0];
-    double h = x[1] - x[0];
-    double u = (value - x[0]) / h;
-    double u_term = u;
-
-    for (int i = 1; i < n; ++i) {
-        result += (u_term * diffTable[0][i]) / factorial(i);
-        u_term *= (u - i);
+int main(int argc, char** argv) {
+    BatchOptions batch;
+    if (batchMode(argc, argv, batch)) {
+        return runBatchMode(batch, runBatch);
     }
 
-    return result;
-}
-
-int main() {
     int n;
     cout << "Enter the number of data points: ";
     cin >> n;
@@ -62,19 +89,60 @@ int main() {
         cin >> y[i];
     }
 
-    vector<vector<double>> diffTable = forwardDifferences(y, n);
+    int choice;
+    cout << "Choose method:\n1. Newton forward differences (equally spaced x)\n2. Local Newton divided differences (any spacing)\n";
+    cin >> choice;
+
+    NewtonForward polynomial;
+    unique_ptr<InterpolationIndex> index;
+    if (choice == 2) {
+        int degree;
+        cout << "Enter the degree of the local polynomials: ";
+        cin >> degree;
+        try {
+            index.reset(new InterpolationIndex(x, y, degree));
+        } catch (runtime_error& e) {
+            cerr << e.what() << endl;
+            return -1;
+        }
+    } else {
+        vector<double> tail;
+        vector<double> leading = forwardDifferences(y, n, &tail);
+        polynomial = buildNewtonForward(x, leading, tail, n);
+
+        int appended;
+        cout << "Enter the number of samples to append (0 for none): ";
+        cin >> appended;
+        for (int i = 0; i < appended; ++i) {
+            double xs, ys;
+            cout << "Enter the next x and y values: ";
+            cin >> xs >> ys;
+            try {
+                appendSample(polynomial, xs, ys);
+            } catch (runtime_error& e) {
+                cerr << e.what() << endl;
+                return -1;
+            }
+        }
+    }
 
     int m;
     cout << "Enter the number of f(x) values to calculate: ";
     cin >> m;
 
+    vector<double> values(m), results(m);
     for (int i = 0; i < m; ++i) {
-        double value;
         cout << "Enter the value of x for f(x): ";
-        cin >> value;
+        cin >> values[i];
+    }
 
-        double result = newtonForwardInterpolation(x, diffTable, value, n);
-        cout << "f(" << value << ") = " << setprecision(6) << result << endl;
+    if (index) {
+        index->evaluateBatch(values.data(), results.data(), m);
+    } else {
+        newtonForwardInterpolationBatch(polynomial, values.data(), results.data(), m);
+    }
+    for (int i = 0; i < m; ++i) {
+        cout << "f(" << values[i] << ") = " << setprecision(6) << results[i] << endl;
     }
 
     return 0;
@@ -1,190 +1,198 @@
 #include <iostream>
 #include <cmath>
 #include <string>
-#include <sstream>
 #include <vector>
 #include <functional>
-#include <map>
-#include <cctype>
+#include <stdexcept>
 
-using namespace std;
+#include "batch_io.h"
+#include "dense_matrix.h"
+#include "expression.h"
+#include "nonlinear_systems.h"
 
-// Function to evaluate an expression
-double evaluateExpression(const string& expr, double x, double y) {
-    map<string, double> variables = { {"x", x}, {"y", y} };
+using namespace std;
 
-    auto parseTokens = [](const string& str) -> vector<string> {
-        istringstream iss(str);
-        vector<string> tokens;
-        string token;
-        while (iss >> token) {
-            tokens.push_back(token);
+// Two unknowns are called x and y, larger systems use x1 ... xn
+vector<string> variableNames(int n) {
+    vector<string> names;
+    if (n == 2) {
+        names = {"x", "y"};
+    } else {
+        for (int i = 1; i <= n; ++i) {
+            names.push_back("x" + to_string(i));
         }
-        return tokens;
-    };
+    }
+    return names;
+}
 
-    auto evalSimpleExpr = [&variables](const vector<string>& tokens) -> double {
-        double result = 0;
-        double current = 0;
-        char operation = '+';
-        for (const auto& token : tokens) {
-            if (token == "+" || token == "-" || token == "*" || token == "/" || token == "^") {
-                operation = token[0];
-            } else {
-                double value = 0;
-                if (variables.find(token) != variables.end()) {
-                    value = variables[token];
-                } else {
-                    value = stod(token);
-                }
-                switch (operation) {
-                    case '+': result += current; current = value; break;
-                    case '-': result += current; current = -value; break;
-                    case '*': current *= value; break;
-                    case '/': current /= value; break;
-                    case '^': current = pow(current, value); break;
-                }
-            }
+// Solve a parsed system with method 1 = Newton-Raphson, 2 = accelerated
+// Newton, 3 = Broyden, with the exact (dual-number) Jacobian if requested
+vector<double> solveSystem(int choice, const vector<Expression>& system, bool useDual, const vector<double>& x0,
+                           double tol, int maxIter, SolverStats& stats) {
+    ResidualFunction F = [&system](const vector<double>& x, vector<double>& Fx) {
+        for (size_t i = 0; i < system.size(); ++i) {
+            Fx[i] = system[i].evaluate(x.data());
         }
-        return result + current;
     };
 
-    vector<string> tokens = parseTokens(expr);
-    return evalSimpleExpr(tokens);
-}
-
-// Define the partial derivatives for the Jacobian matrix (numerical approximation)
-double df1dx(const function<double(double, double)>& f1, double x, double y, double h) {
-    return (f1(x + h, y) - f1(x, y)) / h;
-}
-
-double df1dy(const function<double(double, double)>& f1, double x, double y, double h) {
-    return (f1(x, y + h) - f1(x, y)) / h;
-}
-
-double df2dx(const function<double(double, double)>& f2, double x, double y, double h) {
-    return (f2(x + h, y) - f2(x, y)) / h;
-}
+    JacobianFunction exact;
+    if (useDual) {
+        exact = [&system](const vector<double>& x, vector<double>& Fx, DenseMatrix& J) {
+            dualJacobian(system, x, Fx, J);
+        };
+    }
 
-double df2dy(const function<double(double, double)>& f2, double x, double y, double h) {
-    return (f2(x, y + h) - f2(x, y)) / h;
+    switch (choice) {
+        case 1:
+            return newtonRaphson(F, exact, x0, tol, maxIter, stats);
+        case 2:
+            return acceleratedNewton(F, exact, x0, tol, maxIter, stats);
+        case 3:
+            return broyden(F, exact, x0, tol, maxIter, stats);
+    }
+    throw runtime_error("Invalid method " + to_string(choice) + ".");
 }
 
-// Function to calculate the determinant of the Jacobian matrix
-double determinant(double J[2][2]) {
-    return J[0][0] * J[1][1] - J[0][1] * J[1][0];
+// Why a solve did not converge
+string failure(const SolverStats& stats) {
+    if (stats.singular) {
+        return "Jacobian is singular at iteration " + to_string(stats.iterations) + ".";
+    }
+    return "No convergence after " + to_string(stats.iterations) + " iterations.";
 }
 
-// Newton-Raphson method
-void newtonRaphson(const function<double(double, double)>& f1, const function<double(double, double)>& f2, double x0, double y0, double tol, int maxIter) {
-    double x = x0, y = y0;
-    for (int i = 0; i < maxIter; ++i) {
-        double J[2][2] = {
-            { df1dx(f1, x, y, tol), df1dy(f1, x, y, tol) },
-            { df2dx(f2, x, y, tol), df2dy(f2, x, y, tol) }
-        };
-
-        double detJ = determinant(J);
-        if (fabs(detJ) < tol) {
-            cerr << "Jacobian determinant is too close to zero, solution may not be accurate." << endl;
-            break;
-        }
-
-        double invJ[2][2] = {
-            { J[1][1] / detJ, -J[0][1] / detJ },
-            { -J[1][0] / detJ, J[0][0] / detJ }
-        };
-
-        double F[2] = { f1(x, y), f2(x, y) };
-
-        double dx = -(invJ[0][0] * F[0] + invJ[0][1] * F[1]);
-        double dy = -(invJ[1][0] * F[0] + invJ[1][1] * F[1]);
-
-        x += dx;
-        y += dy;
+// Batch mode: each record is a line "method n exact tolerance maxIterations
+// x0_1 ... x0_n" followed by the n equations, one per line (exact = 1 for
+// the automatic-differentiation Jacobian). The output line is the solution
+// followed by the iteration, residual evaluation and Jacobian refresh
+// counts; a solve that does not converge gives an error line instead. A
+// system equal to the previous record's is not parsed again.
+int runBatch(const string& path) {
+    RecordWriter out(cout);
+    try {
+        RecordReader in(path);
+        vector<string> equations, previous;
+        vector<Expression> system;
+        vector<double> x0;
+        while (!in.atEnd()) {
+            int choice = in.integer();
+            int n = in.integer();
+            bool useDual = in.integer() != 0;
+            double tol = in.number();
+            int maxIter = in.integer();
+            if (n <= 0) {
+                in.fail("invalid size");
+            }
+            x0.resize(n);
+            in.numbers(x0.data(), n);
+            equations.resize(n);
+            for (int i = 0; i < n; ++i) {
+                equations[i] = in.textLine();
+            }
 
-        if (sqrt(dx * dx + dy * dy) < tol) {
-            break;
+            try {
+                if (equations != previous) {
+                    previous.clear();
+                    system.clear();
+                    vector<string> names = variableNames(n);
+                    for (int i = 0; i < n; ++i) {
+                        system.push_back(Expression(equations[i], names));
+                    }
+                    previous = equations;
+                }
+                SolverStats stats;
+                vector<double> result = solveSystem(choice, system, useDual, x0, tol, maxIter, stats);
+                if (!stats.converged) {
+                    out.error(failure(stats));
+                    continue;
+                }
+                for (double value : result) {
+                    out.number(value);
+                }
+                out.integer(stats.iterations).integer(stats.residualEvaluations).integer(stats.jacobianRefreshes);
+                out.endRecord();
+            } catch (runtime_error &e) {
+                out.error(e.what());
+            }
         }
+    } catch (runtime_error &e) {
+        out.flush();
+        cerr << e.what() << endl;
+        return -1;
     }
-
-    cout << "Newton-Raphson result: x = " << x << ", y = " << y << endl;
+    return 0;
 }
 
-// Accelerated Newton method
-void acceleratedNewton(const function<double(double, double)>& f1, const function<double(double, double)>& f2, double x0, double y0, double tol, int maxIter) {
-    double x = x0, y = y0;
-    double alpha = 1.0;  // Acceleration factor
-    for (int i = 0; i < maxIter; ++i) {
-        double J[2][2] = {
-            { df1dx(f1, x, y, tol), df1dy(f1, x, y, tol) },
-            { df2dx(f2, x, y, tol), df2dy(f2, x, y, tol) }
-        };
-
-        double detJ = determinant(J);
-        if (fabs(detJ) < tol) {
-            cerr << "Jacobian determinant is too close to zero, solution may not be accurate." << endl;
-            break;
-        }
-
-        double invJ[2][2] = {
-            { J[1][1] / detJ, -J[0][1] / detJ },
-            { -J[1][0] / detJ, J[0][0] / detJ }
-        };
-
-        double F[2] = { f1(x, y), f2(x, y) };
-
-        double dx = -(invJ[0][0] * F[0] + invJ[0][1] * F[1]);
-        double dy = -(invJ[1][0] * F[0] + invJ[1][1] * F[1]);
-
-        x += alpha * dx;
-        y += alpha * dy;
-
-        if (sqrt(dx * dx + dy * dy) < tol) {
-            break;
-        }
+int main(int argc, char** argv) {
+    BatchOptions batch;
+    if (batchMode(argc, argv, batch)) {
+        return runBatchMode(batch, runBatch);
     }
 
-    cout << "Accelerated Newton result: x = " << x << ", y = " << y << endl;
-}
-
-int main() {
-    string eq1, eq2;
-    double x0, y0, tol;
+    int n;
+    double tol;
     int maxIter = 100;
 
     int choice;
-    cout << "Choose method:\n1. Newton-Raphson\n2. Accelerated Newton\n";
+    cout << "Choose method:\n1. Newton-Raphson\n2. Accelerated Newton\n3. Broyden (quasi-Newton)\n";
     cin >> choice;
-    cin.ignore();  // Ignore the newline character after the choice input
 
-    cout << "Enter the first equation f1(x, y) = 0: ";
-    getline(cin, eq1);
+    cout << "Enter the number of equations: ";
+    cin >> n;
+    cin.ignore();  // Ignore the newline character after the number
 
-    cout << "Enter the second equation f2(x, y) = 0: ";
-    getline(cin, eq2);
+    vector<string> names = variableNames(n);
 
-    cout << "Enter initial guess for x (x0): ";
-    cin >> x0;
+    vector<string> equations(n);
+    for (int i = 0; i < n; ++i) {
+        cout << "Enter equation f" << i + 1 << " = 0: ";
+        getline(cin, equations[i]);
+    }
 
-    cout << "Enter initial guess for y (y0): ";
-    cin >> y0;
+    vector<double> x0(n);
+    for (int i = 0; i < n; ++i) {
+        cout << "Enter initial guess for " << names[i] << ": ";
+        cin >> x0[i];
+    }
 
     cout << "Enter tolerance (epsilon): ";
     cin >> tol;
 
-    function<double(double, double)> f1 = [=](double x, double y) { return evaluateExpression(eq1, x, y); };
-    function<double(double, double)> f2 = [=](double x, double y) { return evaluateExpression(eq2, x, y); };
+    int useDual;
+    cout << "Jacobian (1 = exact, automatic differentiation; 0 = finite differences): ";
+    cin >> useDual;
 
-    switch (choice) {
-        case 1:
-            newtonRaphson(f1, f2, x0, y0, tol, maxIter);
-            break;
-        case 2:
-            acceleratedNewton(f1, f2, x0, y0, tol, maxIter);
-            break;
-        default:
-            cout << "Invalid choice" << endl;
+    // Parse all equations once, before the iteration starts
+    vector<Expression> system;
+    try {
+        for (int i = 0; i < n; ++i) {
+            system.push_back(Expression(equations[i], names));
+        }
+    } catch (runtime_error &e) {
+        cerr << e.what() << endl;
+        return -1;
+    }
+
+    const char* labels[] = {"Newton-Raphson", "Accelerated Newton", "Broyden"};
+    if (choice < 1 || choice > 3) {
+        cout << "Invalid choice" << endl;
+        return -1;
+    }
+
+    SolverStats stats;
+    vector<double> result = solveSystem(choice, system, useDual != 0, x0, tol, maxIter, stats);
+    string label = labels[choice - 1];
+
+    cout << label << " result:";
+    for (int i = 0; i < n; ++i) {
+        cout << (i == 0 ? " " : ", ") << names[i] << " = " << result[i];
+    }
+    cout << endl;
+    cout << "Iterations = " << stats.iterations << ", residual evaluations = " << stats.residualEvaluations
+         << ", Jacobian refreshes = " << stats.jacobianRefreshes << endl;
+    if (!stats.converged) {
+        cerr << failure(stats) << " The solution may not be accurate." << endl;
+        return -1;
     }
 
     return 0;
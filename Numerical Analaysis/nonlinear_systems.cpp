@@ -0,0 +1,258 @@
+#include <cmath>
+#include <cfloat>
+#include <vector>
+#include <memory>
+#include <stdexcept>
+
+#include "lu.h"
+#include "nonlinear_systems.h"
+#include "solver_stats.h"
+
+using namespace std;
+
+double norm2(const vector<double>& v) {
+    double sum = 0.0;
+    for (double value : v) {
+        sum += value * value;
+    }
+    return sqrt(sum);
+}
+
+void jacobian(const ResidualFunction& F, const vector<double>& x, const vector<double>& Fx, DenseMatrix& J, SolverStats& stats) {
+    int n = x.size();
+    #pragma omp parallel
+    {
+        vector<double> xh(x), Fh(n);
+        #pragma omp for schedule(dynamic)
+        for (int j = 0; j < n; ++j) {
+            double h = sqrt(DBL_EPSILON) * max(1.0, fabs(x[j]));
+            xh[j] = x[j] + h;
+            F(xh, Fh);
+            xh[j] = x[j];
+            for (int i = 0; i < n; ++i) {
+                J(i, j) = (Fh[i] - Fx[i]) / h;
+            }
+        }
+    }
+    stats.residualEvaluations += n;
+    stats.jacobianRefreshes++;
+}
+
+void dualJacobian(const vector<Expression>& system, const vector<double>& x, vector<double>& Fx, DenseMatrix& J) {
+    int n = x.size();
+    int equations = system.size();
+    vector<DualNumber> vars(x.begin(), x.end());
+    for (int j0 = 0; j0 < n; j0 += DualWidth) {
+        int width = min(DualWidth, n - j0);
+        for (int k = 0; k < width; ++k) {
+            vars[j0 + k].grad[k] = 1.0;
+        }
+        #pragma omp parallel for schedule(dynamic)
+        for (int i = 0; i < equations; ++i) {
+            DualNumber r = system[i].evaluate(vars.data());
+            Fx[i] = r.value;
+            for (int k = 0; k < width; ++k) {
+                J(i, j0 + k) = r.grad[k];
+            }
+        }
+        for (int k = 0; k < width; ++k) {
+            vars[j0 + k].grad[k] = 0.0;
+        }
+    }
+}
+
+void evaluateJacobian(const ResidualFunction& F, const JacobianFunction& exact, const vector<double>& x, vector<double>& Fx, DenseMatrix& J, SolverStats& stats) {
+    if (exact) {
+        exact(x, Fx, J);
+        stats.jacobianRefreshes++;
+        return;
+    }
+    F(x, Fx);
+    stats.residualEvaluations++;
+    jacobian(F, x, Fx, J, stats);
+}
+
+vector<double> newtonRaphson(const ResidualFunction& F, const JacobianFunction& exact, vector<double> x, double tol, int maxIter, SolverStats& stats, double alpha) {
+    int n = x.size();
+    vector<double> Fx(n);
+    DenseMatrix J(n, n);
+    SolveTimer timer("newton_raphson");
+    double residual = NAN;  // |F| at the latest iterate it was evaluated at
+    for (int i = 0; i < maxIter; ++i) {
+        stats.iterations = i + 1;
+        evaluateJacobian(F, exact, x, Fx, J, stats);
+        // An iterate on the root needs no step, even where J is singular
+        residual = norm2(Fx);
+        if (residual < tol) {
+            stats.converged = true;
+            break;
+        }
+
+        vector<double> dx(n);
+        for (int k = 0; k < n; ++k) {
+            dx[k] = -Fx[k];
+        }
+        try {
+            LUFactorization lu(J);
+            lu.solveInPlace(dx);
+        } catch (runtime_error&) {
+            stats.singular = true;
+            break;
+        }
+
+        for (int k = 0; k < n; ++k) {
+            x[k] += alpha * dx[k];
+        }
+        if (norm2(dx) < tol) {
+            stats.converged = true;
+            break;
+        }
+    }
+    timer.finish(stats.iterations, stats.residualEvaluations, residual);
+    return x;
+}
+
+vector<double> acceleratedNewton(const ResidualFunction& F, const JacobianFunction& exact, vector<double> x, double tol, int maxIter, SolverStats& stats) {
+    const double decrease = 1e-4;  // Armijo constant
+    const int maxHalvings = 30;
+    int n = x.size();
+    vector<double> Fx(n), Ft(n), dx(n), trial(n);
+    DenseMatrix J(n, n);
+    SolveTimer timer("accelerated_newton");
+    double residual = NAN;
+    for (int i = 0; i < maxIter; ++i) {
+        stats.iterations = i + 1;
+        evaluateJacobian(F, exact, x, Fx, J, stats);
+        residual = norm2(Fx);
+        if (residual < tol) {
+            stats.converged = true;
+            break;
+        }
+
+        for (int k = 0; k < n; ++k) {
+            dx[k] = -Fx[k];
+        }
+        try {
+            LUFactorization lu(J);
+            lu.solveInPlace(dx);
+        } catch (runtime_error&) {
+            stats.singular = true;
+            break;
+        }
+
+        // Backtrack from the full step until |F| drops by the Armijo factor;
+        // if it never does, the shortest step tried is taken
+        double t = 1.0;
+        for (int halving = 0; ; ++halving) {
+            for (int k = 0; k < n; ++k) {
+                trial[k] = x[k] + t * dx[k];
+            }
+            F(trial, Ft);
+            stats.residualEvaluations++;
+            if (norm2(Ft) <= (1 - decrease * t) * residual || halving == maxHalvings) {
+                break;
+            }
+            t /= 2;
+        }
+        x.swap(trial);
+        if (t * norm2(dx) < tol) {
+            stats.converged = true;
+            residual = norm2(Ft);
+            break;
+        }
+    }
+    timer.finish(stats.iterations, stats.residualEvaluations, residual);
+    return x;
+}
+
+vector<double> broyden(const ResidualFunction& F, const JacobianFunction& exact, vector<double> x, double tol, int maxIter, SolverStats& stats, int maxUpdates) {
+    int n = x.size();
+    vector<double> Fx(n), Fnew(n), s(n), Hy(n), y(n);
+    DenseMatrix J(n, n);
+    vector<vector<double>> us, ss;
+    unique_ptr<LUFactorization> lu;
+    SolveTimer timer("broyden");
+    double residual = NAN;
+
+    // Fx already holds F(x) except on the first call
+    auto refresh = [&](bool first) {
+        if (first || exact) {
+            evaluateJacobian(F, exact, x, Fx, J, stats);
+        } else {
+            jacobian(F, x, Fx, J, stats);
+        }
+        lu.reset(new LUFactorization(J));
+        us.clear();
+        ss.clear();
+    };
+
+    // w := H_k w
+    auto applyInverse = [&](vector<double>& w) {
+        lu->solveInPlace(w);
+        for (size_t k = 0; k < us.size(); ++k) {
+            double dot = 0.0;
+            for (int i = 0; i < n; ++i) {
+                dot += ss[k][i] * w[i];
+            }
+            for (int i = 0; i < n; ++i) {
+                w[i] += us[k][i] * dot;
+            }
+        }
+    };
+
+    try {
+        refresh(true);
+        for (int iter = 0; iter < maxIter; ++iter) {
+            stats.iterations = iter + 1;
+            for (int i = 0; i < n; ++i) {
+                s[i] = -Fx[i];
+            }
+            applyInverse(s);
+            for (int i = 0; i < n; ++i) {
+                x[i] += s[i];
+            }
+            F(x, Fnew);
+            stats.residualEvaluations++;
+
+            double stepNorm = norm2(s);
+            double oldNorm = norm2(Fx);
+            double newNorm = norm2(Fnew);
+            residual = newNorm;
+            for (int i = 0; i < n; ++i) {
+                y[i] = Fnew[i] - Fx[i];
+            }
+            Fx.swap(Fnew);
+            if (stepNorm < tol || newNorm < tol) {
+                stats.converged = true;
+                break;
+            }
+
+            if (newNorm >= oldNorm || static_cast<int>(us.size()) >= maxUpdates) {
+                refresh(false);
+                continue;
+            }
+
+            // u = (s - H y) / (s^T H y)
+            Hy = y;
+            applyInverse(Hy);
+            double denominator = 0.0;
+            for (int i = 0; i < n; ++i) {
+                denominator += s[i] * Hy[i];
+            }
+            if (fabs(denominator) < 1e-14 * stepNorm * stepNorm) {
+                refresh(false);
+                continue;
+            }
+            vector<double> u(n);
+            for (int i = 0; i < n; ++i) {
+                u[i] = (s[i] - Hy[i]) / denominator;
+            }
+            us.push_back(u);
+            ss.push_back(s);
+        }
+    } catch (runtime_error&) {
+        stats.singular = true;
+    }
+    timer.finish(stats.iterations, stats.residualEvaluations, residual);
+    return x;
+}
@@ -0,0 +1,72 @@
+#ifndef NONLINEAR_SYSTEMS_H
+#define NONLINEAR_SYSTEMS_H
+
+#include <functional>
+#include <vector>
+
+#include "dense_matrix.h"
+#include "dual.h"
+#include "expression.h"
+
+// System of n nonlinear equations F(x) = 0 in n unknowns.
+// The function writes F(x) into its second argument; it is called from
+// several threads at once while a Jacobian is formed, so it must not modify
+// shared state.
+typedef std::function<void(const std::vector<double>&, std::vector<double>&)> ResidualFunction;
+
+// Exact Jacobian: writes F(x) and J(x) together. When a solver is given an
+// empty JacobianFunction it falls back to forward differences of F.
+typedef std::function<void(const std::vector<double>&, std::vector<double>&, DenseMatrix&)> JacobianFunction;
+
+// Directions carried by one dual-number pass
+const int DualWidth = 8;
+typedef Dual<DualWidth> DualNumber;
+
+// Work done by a solve and how it ended. The solvers do no I/O: a run that
+// hits maxIter or a singular Jacobian returns its last iterate with
+// converged = false, and singular tells the two apart.
+struct SolverStats {
+    int iterations = 0;
+    int residualEvaluations = 0;
+    int jacobianRefreshes = 0;
+    bool converged = false;
+    bool singular = false;
+};
+
+// Euclidean norm
+double norm2(const std::vector<double>& v);
+
+// Forward-difference Jacobian J(i, j) = dF_i/dx_j (numerical approximation).
+// Each column needs one extra residual evaluation; the columns are
+// independent and are split across threads with OpenMP.
+void jacobian(const ResidualFunction& F, const std::vector<double>& x, const std::vector<double>& Fx, DenseMatrix& J, SolverStats& stats);
+
+// Exact Jacobian of a system of expressions by forward-mode automatic
+// differentiation. The unknowns are seeded DualWidth at a time, so each
+// pass over the equations yields F and DualWidth columns of J; the
+// equations of a pass are evaluated in parallel.
+void dualJacobian(const std::vector<Expression>& system, const std::vector<double>& x, std::vector<double>& Fx, DenseMatrix& J);
+
+// F(x) and J(x) at the current point, exactly when possible
+void evaluateJacobian(const ResidualFunction& F, const JacobianFunction& exact, const std::vector<double>& x, std::vector<double>& Fx, DenseMatrix& J, SolverStats& stats);
+
+// Newton-Raphson method: the step solves J(x) dx = -F(x) with an LU
+// factorization. alpha scales the step (alpha = 1 is the plain method).
+std::vector<double> newtonRaphson(const ResidualFunction& F, const JacobianFunction& exact, std::vector<double> x, double tol, int maxIter, SolverStats& stats, double alpha = 1.0);
+
+// Accelerated (globalized) Newton method: the Newton step is halved until
+// |F| decreases by the Armijo condition |F(x + t dx)| <= (1 - 1e-4 t) |F(x)|,
+// so a full step that overshoots is cut back instead of diverging. Near the
+// root the full step is accepted and convergence is quadratic as in
+// newtonRaphson; each trial step costs one residual evaluation.
+std::vector<double> acceleratedNewton(const ResidualFunction& F, const JacobianFunction& exact, std::vector<double> x, double tol, int maxIter, SolverStats& stats);
+
+// Broyden's (good) quasi-Newton method.
+// The Jacobian is formed and LU-factored only at the start and on a
+// refresh; in between, every step makes a rank-1 update of the inverse,
+// stored in product form H_k = (I + u_{k-1} s_{k-1}^T) ... (I + u_0 s_0^T) J^-1,
+// so applying H_k costs one LU solve plus O(k n). The Jacobian is refreshed
+// when the residual stops decreasing or after maxUpdates updates.
+std::vector<double> broyden(const ResidualFunction& F, const JacobianFunction& exact, std::vector<double> x, double tol, int maxIter, SolverStats& stats, int maxUpdates = 30);
+
+#endif
@@ -0,0 +1,14 @@
+#include <memory>
+#include <string>
+
+#include "expression.h"
+#include "ode.h"
+
+RhsFunction parseFunction(const std::string& expression) {
+    if (expression == ExampleRhs::expression) {
+        return ExampleRhs();
+    }
+    // Shared so that copies of the RhsFunction do not copy the bytecode
+    auto compiled = std::make_shared<Expression>(expression);
+    return [compiled](double x, double y) { return compiled->evaluate(x, y); };
+}
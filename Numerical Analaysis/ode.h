@@ -0,0 +1,276 @@
+#ifndef ODE_H
+#define ODE_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <string>
+
+#include "solver_stats.h"
+#include "trajectory_writer.h"
+
+// The integrators are templates on the right-hand side, so a lambda or
+// function object is inlined into the stepping loop. RhsFunction is the
+// type-erased fallback for right-hand sides only known at run time; it
+// costs an indirect call per stage.
+typedef std::function<double(double, double)> RhsFunction;
+
+template <typename F>
+inline double evaluateFunction(const F& func, double x, double y) {
+    return func(x, y);
+}
+
+// Built-in right-hand side f(x, y) = 3x - xy
+struct ExampleRhs {
+    static constexpr const char* expression = "3*x - x*y";
+    double operator()(double x, double y) const {
+        return 3*x - x*y;
+    }
+};
+
+// Right-hand side f(x, y) from its text. The example equation maps to
+// ExampleRhs, anything else is compiled once into an Expression in x and y.
+// Throws std::runtime_error if the text is not a valid expression.
+RhsFunction parseFunction(const std::string& expression);
+
+// Euler's Method
+template <typename F>
+double eulerMethod(double x0, double y0, double h, int steps, const F& func) {
+    SolveTimer timer("euler");
+    double x = x0, y = y0;
+    for (int i = 0; i < steps; i++) {
+        y = y + h * evaluateFunction(func, x, y);
+        x = x + h;
+    }
+    timer.finish(steps, steps, NAN);
+    return y;
+}
+
+// Second-order Runge-Kutta Method (Heun's Method)
+template <typename F>
+double rungeKutta2(double x0, double y0, double h, int steps, const F& func) {
+    SolveTimer timer("rk2");
+    double x = x0, y = y0;
+    for (int i = 0; i < steps; i++) {
+        double k1 = evaluateFunction(func, x, y);
+        double k2 = evaluateFunction(func, x + h, y + h * k1);
+        y = y + (h/2) * (k1 + k2);
+        x = x + h;
+    }
+    timer.finish(steps, 2L * steps, NAN);
+    return y;
+}
+
+// Fourth-order Runge-Kutta Method
+// When an output stage is given, every step is passed to it together with
+// the slopes at both ends; the slope at the end of a step is reused as k1 of
+// the next step, so streaming the trajectory costs one extra evaluation in
+// total (the slope at the start), not one per step.
+template <typename F>
+double rungeKutta4(double x0, double y0, double h, int steps, const F& func,
+                   TrajectoryOutput* output = nullptr) {
+    SolveTimer timer("rk4");
+    double x = x0, y = y0;
+    double k1 = 0.0;
+    if (output) {
+        k1 = evaluateFunction(func, x, y);
+        output->start(x, y);
+    }
+    for (int i = 0; i < steps; i++) {
+        if (!output) {
+            k1 = evaluateFunction(func, x, y);
+        }
+        double k2 = evaluateFunction(func, x + h/2, y + h*k1/2);
+        double k3 = evaluateFunction(func, x + h/2, y + h*k2/2);
+        double k4 = evaluateFunction(func, x + h, y + h*k3);
+        double yNew = y + (h/6) * (k1 + 2*k2 + 2*k3 + k4);
+        double xNew = x + h;
+        if (output) {
+            double kNew = evaluateFunction(func, xNew, yNew);
+            output->step(x, y, k1, xNew, yNew, kNew);
+            k1 = kNew;
+        }
+        x = xNew;
+        y = yNew;
+    }
+    if (output) {
+        output->finish();
+    }
+    timer.finish(steps, 4L * steps + (output ? 1 : 0), NAN);
+    return y;
+}
+
+// Step statistics of the adaptive solver
+struct StepStats {
+    int accepted = 0;
+    int rejected = 0;
+    int evaluations = 0;
+};
+
+// Adaptive Dormand-Prince 5(4) method, integrating from x0 to xEnd.
+// The 4th order embedded solution estimates the local error, which is kept
+// below atol + rtol * |y| per step. The step size follows a PI controller and
+// the last stage of an accepted step is reused as the first stage of the next
+// one (FSAL), so an accepted step costs 6 function evaluations.
+// Throws std::runtime_error if the step size underflows before xEnd.
+template <typename F>
+double dormandPrince(double x0, double y0, double xEnd, double atol, double rtol,
+                     const F& func, StepStats& stats,
+                     TrajectoryOutput* output = nullptr) {
+    const double c2 = 1.0/5, c3 = 3.0/10, c4 = 4.0/5, c5 = 8.0/9;
+    const double a21 = 1.0/5;
+    const double a31 = 3.0/40, a32 = 9.0/40;
+    const double a41 = 44.0/45, a42 = -56.0/15, a43 = 32.0/9;
+    const double a51 = 19372.0/6561, a52 = -25360.0/2187, a53 = 64448.0/6561, a54 = -212.0/729;
+    const double a61 = 9017.0/3168, a62 = -355.0/33, a63 = 46732.0/5247, a64 = 49.0/176, a65 = -5103.0/18656;
+    const double b1 = 35.0/384, b3 = 500.0/1113, b4 = 125.0/192, b5 = -2187.0/6784, b6 = 11.0/84;
+    // Difference between the 5th and 4th order weights
+    const double e1 = 71.0/57600, e3 = -71.0/16695, e4 = 71.0/1920, e5 = -17253.0/339200, e6 = 22.0/525, e7 = -1.0/40;
+
+    // PI controller parameters (Hairer, Norsett & Wanner)
+    const double beta = 0.04, alpha = 0.2 - 0.75 * beta;
+    const double safety = 0.9, minFactor = 0.2, maxFactor = 10.0;
+
+    SolveTimer timer("dormand_prince");
+    stats = StepStats();
+    double x = x0, y = y0;
+    double span = xEnd - x0;
+    if (span == 0.0) {
+        timer.finish(0, 0, NAN);
+        return y;
+    }
+    double direction = span > 0 ? 1.0 : -1.0;
+
+    double k1 = evaluateFunction(func, x, y);
+    stats.evaluations++;
+
+    // Initial step from the size of y and its slope
+    double scale = atol + rtol * fabs(y);
+    double h = (fabs(k1) > 1e-10 * scale) ? 0.01 * std::max(scale, fabs(y)) / fabs(k1) : 0.01 * fabs(span);
+    h = std::min(h, fabs(span));
+
+    if (output) {
+        output->start(x, y);
+    }
+
+    double errPrev = 1e-4;
+    double err = NAN;  // scaled error estimate of the last step tried
+    bool lastRejected = false;
+    while (direction * (xEnd - x) > 0) {
+        if (h < 1e-14 * std::max(1.0, fabs(x))) {
+            timer.finish(stats.accepted + stats.rejected, stats.evaluations, err);
+            throw std::runtime_error("Step size underflow at x = " + std::to_string(x) + ".");
+        }
+        double step = direction * std::min(h, fabs(xEnd - x));
+
+        double k2 = evaluateFunction(func, x + c2*step, y + step*(a21*k1));
+        double k3 = evaluateFunction(func, x + c3*step, y + step*(a31*k1 + a32*k2));
+        double k4 = evaluateFunction(func, x + c4*step, y + step*(a41*k1 + a42*k2 + a43*k3));
+        double k5 = evaluateFunction(func, x + c5*step, y + step*(a51*k1 + a52*k2 + a53*k3 + a54*k4));
+        double k6 = evaluateFunction(func, x + step, y + step*(a61*k1 + a62*k2 + a63*k3 + a64*k4 + a65*k5));
+        double yNew = y + step*(b1*k1 + b3*k3 + b4*k4 + b5*k5 + b6*k6);
+        double k7 = evaluateFunction(func, x + step, yNew);
+        stats.evaluations += 6;
+
+        double errorEstimate = step*(e1*k1 + e3*k3 + e4*k4 + e5*k5 + e6*k6 + e7*k7);
+        err = fabs(errorEstimate) / (atol + rtol * std::max(fabs(y), fabs(yNew)));
+
+        if (err <= 1.0) {
+            double factor = (err == 0.0) ? maxFactor : safety * pow(err, -alpha) * pow(errPrev, beta);
+            factor = std::min(maxFactor, std::max(minFactor, factor));
+            if (lastRejected) {
+                factor = std::min(factor, 1.0);
+            }
+            if (output) {
+                output->step(x, y, k1, x + step, yNew, k7);
+            }
+            x += step;
+            y = yNew;
+            k1 = k7;  // FSAL
+            h = fabs(step) * factor;
+            errPrev = std::max(err, 1e-4);
+            lastRejected = false;
+            stats.accepted++;
+        } else {
+            double factor = std::max(minFactor, safety * pow(err, -alpha));
+            h = fabs(step) * factor;
+            lastRejected = true;
+            stats.rejected++;
+        }
+    }
+    if (output) {
+        output->finish();
+    }
+    timer.finish(stats.accepted + stats.rejected, stats.evaluations, err);
+    return y;
+}
+
+// Batched integration of many trajectories of the same ODE.
+// The initial values are given as structure-of-arrays (x[i], y[i]) and are
+// overwritten with the values after `steps` steps. All trajectories advance
+// in lockstep: trajectories are processed in chunks that stay in L1 cache,
+// the loop over the trajectories of a chunk is vectorized, and the chunks
+// are split across threads with OpenMP. The callable is a template parameter
+// so that a plain lambda is inlined into the vector loop.
+const size_t BatchChunk = 512;
+
+template <typename F>
+void eulerBatch(double* x, double* y, size_t count, double h, int steps, F func) {
+    SolveTimer timer("euler_batch");
+    #pragma omp parallel for schedule(static)
+    for (size_t start = 0; start < count; start += BatchChunk) {
+        size_t end = std::min(start + BatchChunk, count);
+        for (int s = 0; s < steps; s++) {
+            #pragma omp simd
+            for (size_t i = start; i < end; i++) {
+                y[i] = y[i] + h * func(x[i], y[i]);
+                x[i] = x[i] + h;
+            }
+        }
+    }
+    timer.finish(steps, count * steps, NAN);
+}
+
+template <typename F>
+void rungeKutta2Batch(double* x, double* y, size_t count, double h, int steps, F func) {
+    SolveTimer timer("rk2_batch");
+    #pragma omp parallel for schedule(static)
+    for (size_t start = 0; start < count; start += BatchChunk) {
+        size_t end = std::min(start + BatchChunk, count);
+        for (int s = 0; s < steps; s++) {
+            #pragma omp simd
+            for (size_t i = start; i < end; i++) {
+                double k1 = func(x[i], y[i]);
+                double k2 = func(x[i] + h, y[i] + h * k1);
+                y[i] = y[i] + (h/2) * (k1 + k2);
+                x[i] = x[i] + h;
+            }
+        }
+    }
+    timer.finish(steps, 2 * count * steps, NAN);
+}
+
+template <typename F>
+void rungeKutta4Batch(double* x, double* y, size_t count, double h, int steps, F func) {
+    SolveTimer timer("rk4_batch");
+    #pragma omp parallel for schedule(static)
+    for (size_t start = 0; start < count; start += BatchChunk) {
+        size_t end = std::min(start + BatchChunk, count);
+        for (int s = 0; s < steps; s++) {
+            #pragma omp simd
+            for (size_t i = start; i < end; i++) {
+                double k1 = func(x[i], y[i]);
+                double k2 = func(x[i] + h/2, y[i] + h*k1/2);
+                double k3 = func(x[i] + h/2, y[i] + h*k2/2);
+                double k4 = func(x[i] + h, y[i] + h*k3);
+                y[i] = y[i] + (h/6) * (k1 + 2*k2 + 2*k3 + k4);
+                x[i] = x[i] + h;
+            }
+        }
+    }
+    timer.finish(steps, 4 * count * steps, NAN);
+}
+
+#endif
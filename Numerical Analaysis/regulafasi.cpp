@@ -1,116 +1,84 @@
 #include <iostream>
-#include <boost/spirit/include/qi.hpp>
-#include <boost/spirit/include/phoenix.hpp>
 #include <cmath>
 #include <string>
 #include <iomanip>
+#include <stdexcept>
 
-namespace qi = boost::spirit::qi;
-namespace ascii = boost::spirit::ascii;
-namespace phoenix = boost::phoenix;
+#include "batch_io.h"
+#include "expression.h"
+#include "root_finding.h"
 
-// Kullanıcıdan alınan ifadeyi çözümleyen bir parser fonksiyonu
-struct ExpressionParser : qi::grammar<std::string::const_iterator, double(double), ascii::space_type> {
-    ExpressionParser() : ExpressionParser::base_type(expression) {
-        using qi::_1;
-        using qi::_val;
-        using qi::double_;
-        using qi::char_;
-        using phoenix::ref;
-
-        expression =
-            term[_val = _1] >>
-            *(   ('+' >> term[_val += _1])
-               | ('-' >> term[_val -= _1])
-             );
-
-        term =
-            factor[_val = _1] >>
-            *(   ('*' >> factor[_val *= _1])
-               | ('/' >> factor[_val /= _1])
-             );
-
-        factor =
-            double_[_val = _1]
-            |   '(' >> expression[_val = _1] >> ')'
-            |   ('-' >> factor[_val = -_1])
-            |   ('+' >> factor[_val = _1])
-            |   (qi::lit("cos") >> '(' >> expression[_val = phoenix::bind(&std::cos, _1)] >> ')');
-    }
-
-    qi::rule<std::string::const_iterator, double(double), ascii::space_type> expression, term, factor;
-};
-
-// f(x) fonksiyonu, kullanıcıdan alınan denklemi değerlendirir
-double f(const std::string& expr, double x) {
-    ExpressionParser parser;
-    std::string::const_iterator iter = expr.begin();
-    std::string::const_iterator end = expr.end();
-    double result;
-
-    bool r = phrase_parse(iter, end, parser(x), ascii::space, result);
-    if (r && iter == end) {
-        return result;
-    } else {
-        std::cerr << "Parsing failed\n";
-        return 0.0;
-    }
+// Sonucu yöntemin adıyla birlikte yazdırır
+void report(const char* method, const RootResult& result) {
+    std::cout << method << ": Root = " << result.root << ", Iterations = " << result.iterations
+              << ", Evaluations = " << result.evaluations << std::endl;
 }
 
-// Kesen Kök Yöntemi (Secant Method)
-void secantMethod(const std::string& expr, double x0, double x1, double epsilon, int maxIterations) {
-    double x2;
-    int iteration = 0;
-    while (fabs(f(expr, x1)) > epsilon && iteration < maxIterations) {
-        x2 = x1 - f(expr, x1) * (x1 - x0) / (f(expr, x1) - f(expr, x0));
-        x0 = x1;
-        x1 = x2;
-        iteration++;
+// Tek bir yöntemi numarasıyla çalıştırır (1 = Secant ... 6 = Brent)
+RootResult solve(int method, const Expression& expr, double x0, double x1, double epsilon, int maxIterations) {
+    switch (method) {
+        case 1: return secantMethod(expr, x0, x1, epsilon, maxIterations);
+        case 2: return regulaFalsi(expr, x0, x1, epsilon, maxIterations);
+        case 3: return bisectionMethod(expr, x0, x1, epsilon, maxIterations);
+        case 4: return modifiedRegulaFalsi(expr, x0, x1, epsilon, maxIterations, false);
+        case 5: return modifiedRegulaFalsi(expr, x0, x1, epsilon, maxIterations, true);
+        case 6: return brentMethod(expr, x0, x1, epsilon, maxIterations);
     }
-    std::cout << "Secant Method: Root = " << x1 << ", Iterations = " << iteration << std::endl;
+    throw std::runtime_error("Invalid method " + std::to_string(method) + ".");
 }
 
-// Regula Falsi Yöntemi
-void regulaFalsi(const std::string& expr, double x0, double x1, double epsilon, int maxIterations) {
-    double x2 = x0;
-    int iteration = 0;
-    while (fabs(f(expr, x2)) > epsilon && iteration < maxIterations) {
-        x2 = x0 - f(expr, x0) * (x1 - x0) / (f(expr, x1) - f(expr, x0));
-        if (f(expr, x0) * f(expr, x2) < 0) {
-            x1 = x2;
-        } else {
-            x0 = x2;
+// Toplu mod: her kayıt tek satırdır, "method x0 x1 epsilon maxIterations f(x)".
+// Her kayıt için "root iterations evaluations" satırı yazılır. Denklem bir
+// önceki kayıttakiyle aynıysa yeniden derlenmez.
+int runBatch(const std::string& path) {
+    RecordWriter out(std::cout);
+    try {
+        RecordReader in(path);
+        std::string previous;
+        Expression expr;
+        bool compiled = false;
+        while (!in.atEnd()) {
+            int method = in.integer();
+            double x0 = in.number();
+            double x1 = in.number();
+            double epsilon = in.number();
+            int maxIterations = in.integer();
+            std::string source = in.textLine();
+            try {
+                if (!compiled || source != previous) {
+                    compiled = false;
+                    expr = Expression(source);
+                    previous = source;
+                    compiled = true;
+                }
+                RootResult result = solve(method, expr, x0, x1, epsilon, maxIterations);
+                out.number(result.root).integer(result.iterations).integer(result.evaluations);
+                out.endRecord();
+            } catch (std::runtime_error& e) {
+                out.error(e.what());
+            }
         }
-        iteration++;
+    } catch (std::runtime_error& e) {
+        out.flush();
+        std::cerr << e.what() << std::endl;
+        return -1;
     }
-    std::cout << "Regula Falsi Method: Root = " << x2 << ", Iterations = " << iteration << std::endl;
+    return 0;
 }
 
-// Bolzano Yöntemi (Bisection Method)
-void bisectionMethod(const std::string& expr, double x0, double x1, double epsilon, int maxIterations) {
-    double x2;
-    int iteration = 0;
-    while ((x1 - x0) / 2 > epsilon && iteration < maxIterations) {
-        x2 = (x0 + x1) / 2;
-        if (f(expr, x2) == 0.0) {
-            break;
-        } else if (f(expr, x0) * f(expr, x2) < 0) {
-            x1 = x2;
-        } else {
-            x0 = x2;
-        }
-        iteration++;
+int main(int argc, char** argv) {
+    BatchOptions batch;
+    if (batchMode(argc, argv, batch)) {
+        return runBatchMode(batch, runBatch);
     }
-    std::cout << "Bisection Method: Root = " << x2 << ", Iterations = " << iteration << std::endl;
-}
 
-int main() {
-    std::string expr;
+    std::string source;
     double x0, x1, epsilon;
     int maxIterations;
+    int method = 0;
 
     std::cout << "Enter the equation f(x) = 0 (e.g., cos(x) - x): ";
-    std::getline(std::cin, expr);
+    std::getline(std::cin, source);
     std::cout << "Enter initial guess x0: ";
     std::cin >> x0;
     std::cout << "Enter initial guess x1: ";
@@ -119,15 +87,50 @@ int main() {
     std::cin >> epsilon;
     std::cout << "Enter maximum iterations: ";
     std::cin >> maxIterations;
+    std::cout << "Choose method (0 = all, 1 = Secant, 2 = Regula Falsi, 3 = Bisection, "
+                 "4 = Illinois, 5 = Anderson-Bjorck, 6 = Brent): ";
+    std::cin >> method;
+
+    // Denklem yalnızca bir kez çözümlenir
+    Expression expr;
+    try {
+        expr = Expression(source);
+    } catch (std::runtime_error& e) {
+        std::cerr << e.what() << std::endl;
+        return -1;
+    }
 
     // a) Kesen Kök
-    secantMethod(expr, x0, x1, epsilon, maxIterations);
+    if (method == 0 || method == 1) {
+        report("Secant Method", secantMethod(expr, x0, x1, epsilon, maxIterations));
+    }
 
     // b) Regula Falsi
-    regulaFalsi(expr, x0, x1, epsilon, maxIterations);
+    if (method == 0 || method == 2) {
+        report("Regula Falsi Method", regulaFalsi(expr, x0, x1, epsilon, maxIterations));
+    }
 
     // c) Bolzano (Bisection)
-    bisectionMethod(expr, x0, x1, epsilon, maxIterations);
+    if (method == 0 || method == 3) {
+        report("Bisection Method", bisectionMethod(expr, x0, x1, epsilon, maxIterations));
+    }
+
+    // d) Illinois ve Anderson-Björck
+    if (method == 0 || method == 4) {
+        report("Illinois Method", modifiedRegulaFalsi(expr, x0, x1, epsilon, maxIterations, false));
+    }
+    if (method == 0 || method == 5) {
+        report("Anderson-Bjorck Method", modifiedRegulaFalsi(expr, x0, x1, epsilon, maxIterations, true));
+    }
+
+    // e) Brent
+    if (method == 0 || method == 6) {
+        try {
+            report("Brent Method", brentMethod(expr, x0, x1, epsilon, maxIterations));
+        } catch (std::runtime_error& e) {
+            std::cout << "Brent Method: " << e.what() << std::endl;
+        }
+    }
 
     return 0;
 }
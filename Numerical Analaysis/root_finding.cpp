@@ -0,0 +1,206 @@
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+#include "root_finding.h"
+#include "solver_stats.h"
+
+// f(x) fonksiyonu, kullanıcıdan alınan ve bir kez derlenen denklemi değerlendirir
+// ve değerlendirme sayacını artırır
+static double f(const Expression& expr, double x, int& evaluations) {
+    evaluations++;
+    return expr(x);
+}
+
+RootResult secantMethod(const Expression& expr, double x0, double x1, double epsilon, int maxIterations) {
+    SolveTimer timer("secant");
+    int evaluations = 0;
+    double f0 = f(expr, x0, evaluations);
+    double f1 = f(expr, x1, evaluations);
+    int iteration = 0;
+    while (fabs(f1) > epsilon && iteration < maxIterations) {
+        double x2 = x1 - f1 * (x1 - x0) / (f1 - f0);
+        x0 = x1;
+        f0 = f1;
+        x1 = x2;
+        f1 = f(expr, x1, evaluations);
+        iteration++;
+    }
+    timer.finish(iteration, evaluations, fabs(f1));
+    return {x1, iteration, evaluations};
+}
+
+RootResult regulaFalsi(const Expression& expr, double x0, double x1, double epsilon, int maxIterations) {
+    SolveTimer timer("regula_falsi");
+    int evaluations = 0;
+    double f0 = f(expr, x0, evaluations);
+    double f1 = f(expr, x1, evaluations);
+    double x2 = x0;
+    double f2 = f0;
+    int iteration = 0;
+    while (fabs(f2) > epsilon && iteration < maxIterations) {
+        x2 = x0 - f0 * (x1 - x0) / (f1 - f0);
+        f2 = f(expr, x2, evaluations);
+        if (f0 * f2 < 0) {
+            x1 = x2;
+            f1 = f2;
+        } else {
+            x0 = x2;
+            f0 = f2;
+        }
+        iteration++;
+    }
+    timer.finish(iteration, evaluations, fabs(f2));
+    return {x2, iteration, evaluations};
+}
+
+RootResult bisectionMethod(const Expression& expr, double x0, double x1, double epsilon, int maxIterations) {
+    SolveTimer timer("bisection");
+    int evaluations = 0;
+    double f0 = f(expr, x0, evaluations);
+    double x2 = (x0 + x1) / 2;
+    double f2 = NAN;  // f at the last midpoint
+    int iteration = 0;
+    while ((x1 - x0) / 2 > epsilon && iteration < maxIterations) {
+        x2 = (x0 + x1) / 2;
+        f2 = f(expr, x2, evaluations);
+        if (f2 == 0.0) {
+            break;
+        } else if (f0 * f2 < 0) {
+            x1 = x2;
+        } else {
+            x0 = x2;
+            f0 = f2;
+        }
+        iteration++;
+    }
+    timer.finish(iteration, evaluations, fabs(f2));
+    return {x2, iteration, evaluations};
+}
+
+RootResult modifiedRegulaFalsi(const Expression& expr, double x0, double x1, double epsilon, int maxIterations,
+                               bool andersonBjorck) {
+    SolveTimer timer(andersonBjorck ? "anderson_bjorck" : "illinois");
+    int evaluations = 0;
+    double f0 = f(expr, x0, evaluations);
+    double f1 = f(expr, x1, evaluations);
+    double x2 = x0;
+    double f2 = f0;
+    int iteration = 0;
+    while (fabs(f2) > epsilon && iteration < maxIterations) {
+        x2 = x1 - f1 * (x1 - x0) / (f1 - f0);
+        f2 = f(expr, x2, evaluations);
+        if (f2 * f1 < 0) {
+            // Kök x1 ile x2 arasında: x0 atılır, aralık yön değiştirir
+            x0 = x1;
+            f0 = f1;
+        } else {
+            // x0 korunur ve f0 küçültülür
+            double m = 0.5;
+            if (andersonBjorck) {
+                m = 1 - f2 / f1;
+                if (m <= 0) {
+                    m = 0.5;
+                }
+            }
+            f0 *= m;
+        }
+        x1 = x2;
+        f1 = f2;
+        iteration++;
+    }
+    timer.finish(iteration, evaluations, fabs(f2));
+    return {x2, iteration, evaluations};
+}
+
+RootResult brentMethod(const Expression& expr, double x0, double x1, double epsilon, int maxIterations) {
+    SolveTimer timer("brent");
+    int evaluations = 0;
+    double a = x0, b = x1;
+    double fa = f(expr, a, evaluations);
+    double fb = f(expr, b, evaluations);
+    int iteration = 0;
+    if (fa * fb > 0) {
+        throw std::runtime_error("f(x0) and f(x1) must have opposite signs.");
+    }
+    double c = a, fc = fa;
+    double d = b - a, e = d;
+    while (fb != 0 && iteration < maxIterations) {
+        if (fb * fc > 0) {
+            // c, b'nin karşı tarafındaki uç olmalı
+            c = a;
+            fc = fa;
+            d = e = b - a;
+        }
+        if (fabs(fc) < fabs(fb)) {
+            // b her zaman en iyi tahmin olarak tutulur
+            a = b;
+            b = c;
+            c = a;
+            fa = fb;
+            fb = fc;
+            fc = fa;
+        }
+        double tolerance = 2 * 2.2e-16 * fabs(b) + epsilon / 2;
+        double half = (c - b) / 2;
+        if (fabs(half) <= tolerance || fabs(fb) <= epsilon) {
+            break;
+        }
+        if (fabs(e) >= tolerance && fabs(fa) > fabs(fb)) {
+            double p, q;
+            double s = fb / fa;
+            if (a == c) {
+                // İki nokta: kesen adımı
+                p = 2 * half * s;
+                q = 1 - s;
+            } else {
+                // Üç nokta: ters ikinci derece interpolasyon
+                double r = fb / fc;
+                double t = fa / fc;
+                p = s * (2 * half * t * (t - r) - (b - a) * (r - 1));
+                q = (t - 1) * (r - 1) * (s - 1);
+            }
+            if (p > 0) {
+                q = -q;
+            } else {
+                p = -p;
+            }
+            if (2 * p < std::min(3 * half * q - fabs(tolerance * q), fabs(e * q))) {
+                e = d;
+                d = p / q;
+            } else {
+                d = half;
+                e = d;
+            }
+        } else {
+            d = half;
+            e = d;
+        }
+        a = b;
+        fa = fb;
+        b += fabs(d) > tolerance ? d : (half > 0 ? tolerance : -tolerance);
+        fb = f(expr, b, evaluations);
+        iteration++;
+    }
+    timer.finish(iteration, evaluations, fabs(fb));
+    return {b, iteration, evaluations};
+}
+
+RootResult newtonMethod(const Expression& expr, const Expression& derivative, double x0, double epsilon, int maxIterations) {
+    SolveTimer timer("newton");
+    int evaluations = 0;
+    double x = x0;
+    double fx = f(expr, x, evaluations);
+    int iteration = 0;
+    while (fabs(fx) > epsilon && iteration < maxIterations) {
+        double fpx = derivative(x);
+        if (fabs(fpx) < 1e-10) {
+            throw std::runtime_error("Derivative is too small, division by zero risk.");
+        }
+        x = x - fx / fpx;
+        fx = f(expr, x, evaluations);
+        iteration++;
+    }
+    timer.finish(iteration, evaluations, fabs(fx));
+    return {x, iteration, evaluations};
+}
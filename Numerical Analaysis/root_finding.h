@@ -0,0 +1,48 @@
+#ifndef ROOT_FINDING_H
+#define ROOT_FINDING_H
+
+#include "expression.h"
+
+// Tek değişkenli kök bulma yöntemleri. Her yöntem f(x) = 0 denklemini
+// bir kez derlenmiş bir Expression üzerinde çözer ve kökü, iterasyon
+// sayısını ve f değerlendirme sayısını döndürür; hiçbiri çıktı yazmaz.
+struct RootResult {
+    double root;
+    int iterations;
+    int evaluations;
+};
+
+// Kesen Kök Yöntemi (Secant Method)
+// Her adımda yalnızca yeni nokta değerlendirilir, eski f değerleri taşınır
+RootResult secantMethod(const Expression& expr, double x0, double x1, double epsilon, int maxIterations);
+
+// Regula Falsi Yöntemi
+// Aralık uçlarındaki f değerleri taşınır, her adımda tek değerlendirme yapılır
+RootResult regulaFalsi(const Expression& expr, double x0, double x1, double epsilon, int maxIterations);
+
+// Bolzano Yöntemi (Bisection Method)
+// Sol uçtaki f değeri taşınır, her adımda yalnızca orta nokta değerlendirilir
+RootResult bisectionMethod(const Expression& expr, double x0, double x1, double epsilon, int maxIterations);
+
+// Değiştirilmiş Regula Falsi (Illinois ve Anderson-Björck)
+// Bir uç her korunduğunda (ilk seferden itibaren) o ucun f değeri
+// küçültülür; böylece sabit kalan uç serbest kalır ve yakınsama
+// süperlineer olur.
+// Illinois ağırlığı her zaman 1/2, Anderson-Björck ağırlığı 1 - f2/f1'dir
+// (pozitif değilse 1/2 kullanılır)
+RootResult modifiedRegulaFalsi(const Expression& expr, double x0, double x1, double epsilon, int maxIterations,
+                               bool andersonBjorck);
+
+// Brent Yöntemi
+// Ters ikinci derece interpolasyon, kesen ve ikiye bölmeyi birleştirir.
+// Aralık her adımda korunur; interpolasyon adımı yeterince küçülmezse
+// ikiye bölmeye geçilir, bu yüzden en kötü durumda bile bisection kadar
+// güvenlidir. Durma ölçütü aralık yarı genişliği ile |f| üzerindedir
+RootResult brentMethod(const Expression& expr, double x0, double x1, double epsilon, int maxIterations);
+
+// Newton Yöntemi
+// Türev ayrı bir ifade olarak verilir; |f'(x)| çok küçülürse
+// std::runtime_error fırlatılır
+RootResult newtonMethod(const Expression& expr, const Expression& derivative, double x0, double epsilon, int maxIterations);
+
+#endif
@@ -0,0 +1,77 @@
+#include <cmath>
+#include <cstring>
+#include <ostream>
+#include <vector>
+
+#include "solver_stats.h"
+
+using namespace std;
+
+static thread_local StatsCollector* current = nullptr;
+
+StatsCollector* StatsCollector::active() {
+    return current;
+}
+
+StatsCollection::StatsCollection(StatsCollector& collector) : previous(current) {
+    current = &collector;
+}
+
+StatsCollection::~StatsCollection() {
+    current = previous;
+}
+
+// Non-finite values (a solver without a residual) become null
+static void writeNumber(ostream& out, double value) {
+    if (isfinite(value)) {
+        out << value;
+    } else {
+        out << "null";
+    }
+}
+
+void StatsCollector::writeJson(ostream& out) const {
+    // Totals per solver, in order of first appearance
+    struct Total {
+        const char* solver;
+        long calls, iterations, evaluations;
+        double seconds;
+    };
+    vector<Total> totals;
+    for (const SolveStats& s : entries) {
+        size_t k = 0;
+        while (k < totals.size() && strcmp(totals[k].solver, s.solver) != 0) {
+            k++;
+        }
+        if (k == totals.size()) {
+            totals.push_back({s.solver, 0, 0, 0, 0.0});
+        }
+        totals[k].calls++;
+        totals[k].iterations += s.iterations;
+        totals[k].evaluations += s.evaluations;
+        totals[k].seconds += s.seconds;
+    }
+
+    streamsize precision = out.precision(10);
+    out << "{\n  \"enabled\": " << (NUMERICS_STATS ? "true" : "false") << ",\n  \"summary\": [";
+    for (size_t k = 0; k < totals.size(); k++) {
+        const Total& t = totals[k];
+        out << (k ? ",\n" : "\n") << "    {\"solver\": \"" << t.solver << "\", \"calls\": " << t.calls
+            << ", \"iterations\": " << t.iterations << ", \"evaluations\": " << t.evaluations
+            << ", \"seconds\": ";
+        writeNumber(out, t.seconds);
+        out << "}";
+    }
+    out << "\n  ],\n  \"records\": [";
+    for (size_t k = 0; k < entries.size(); k++) {
+        const SolveStats& s = entries[k];
+        out << (k ? ",\n" : "\n") << "    {\"solver\": \"" << s.solver << "\", \"iterations\": " << s.iterations
+            << ", \"evaluations\": " << s.evaluations << ", \"residual\": ";
+        writeNumber(out, s.residual);
+        out << ", \"seconds\": ";
+        writeNumber(out, s.seconds);
+        out << "}";
+    }
+    out << "\n  ]\n}\n";
+    out.precision(precision);
+}
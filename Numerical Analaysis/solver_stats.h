@@ -0,0 +1,95 @@
+#ifndef SOLVER_STATS_H
+#define SOLVER_STATS_H
+
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <vector>
+
+// Solver instrumentation.
+//
+// Every solver starts a SolveTimer on entry and calls finish() with its
+// iteration count, the number of function (or matrix-vector) evaluations
+// and its final residual. The record goes to the StatsCollector installed
+// on the calling thread by a StatsCollection, so a whole batch of solves
+// can be gathered and exported as JSON. Without an installed collector a
+// timer costs one pointer test; with NUMERICS_STATS set to 0 it is an
+// empty class and compiles away entirely.
+#ifndef NUMERICS_STATS
+#define NUMERICS_STATS 0
+#endif
+
+// One solver call. The residual is the solver's own convergence measure at
+// exit (|f(x)|, a residual norm or the last correction); NaN if it has none.
+struct SolveStats {
+    const char* solver;
+    long iterations;
+    long evaluations;
+    double residual;
+    double seconds;
+};
+
+class StatsCollector {
+public:
+    void add(const SolveStats& stats) { entries.push_back(stats); }
+    const std::vector<SolveStats>& records() const { return entries; }
+    void clear() { entries.clear(); }
+
+    // {"enabled": ..., "summary": [per solver totals], "records": [...]}
+    void writeJson(std::ostream& out) const;
+
+    // Collector of the calling thread, or nullptr
+    static StatsCollector* active();
+
+private:
+    friend class StatsCollection;
+    std::vector<SolveStats> entries;
+};
+
+// Installs a collector for the calling thread for the lifetime of this
+// object (nested installs restore the previous collector)
+class StatsCollection {
+public:
+    explicit StatsCollection(StatsCollector& collector);
+    ~StatsCollection();
+    StatsCollection(const StatsCollection&) = delete;
+    StatsCollection& operator=(const StatsCollection&) = delete;
+
+private:
+    StatsCollector* previous;
+};
+
+#if NUMERICS_STATS
+
+class SolveTimer {
+public:
+    explicit SolveTimer(const char* name) : solver(name), collector(StatsCollector::active()) {
+        if (collector) {
+            start = std::chrono::steady_clock::now();
+        }
+    }
+
+    void finish(long iterations, long evaluations, double residual) {
+        if (collector) {
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            collector->add({solver, iterations, evaluations, residual, seconds});
+        }
+    }
+
+private:
+    const char* solver;
+    StatsCollector* collector;
+    std::chrono::steady_clock::time_point start;
+};
+
+#else
+
+class SolveTimer {
+public:
+    explicit SolveTimer(const char*) {}
+    void finish(long, long, double) {}
+};
+
+#endif
+
+#endif
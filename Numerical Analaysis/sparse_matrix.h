@@ -0,0 +1,193 @@
+#ifndef SPARSE_MATRIX_H
+#define SPARSE_MATRIX_H
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Sparse matrix in compressed sparse row (CSR) form.
+// The entries of row i are values[rowStart[i] .. rowStart[i + 1]) with
+// column indices colIndex[...], sorted by column within each row.
+class SparseMatrix {
+public:
+    SparseMatrix() : nRows(0), nCols(0), rowStart(1, 0) {}
+
+    // Build from (row, col, value) triplets; duplicates are summed
+    SparseMatrix(int rows, int cols, std::vector<int> tripletRows, std::vector<int> tripletCols, std::vector<double> tripletValues)
+        : nRows(rows), nCols(cols), rowStart(rows + 1, 0) {
+        size_t count = tripletValues.size();
+        for (size_t k = 0; k < count; ++k) {
+            if (tripletRows[k] < 0 || tripletRows[k] >= rows || tripletCols[k] < 0 || tripletCols[k] >= cols) {
+                throw std::runtime_error("Sparse matrix entry out of range.");
+            }
+            rowStart[tripletRows[k] + 1]++;
+        }
+        for (int i = 0; i < rows; ++i) {
+            rowStart[i + 1] += rowStart[i];
+        }
+
+        // Counting sort of the triplets by row
+        std::vector<int> next(rowStart.begin(), rowStart.end() - 1);
+        std::vector<std::pair<int, double>> entries(count);
+        for (size_t k = 0; k < count; ++k) {
+            entries[next[tripletRows[k]]++] = {tripletCols[k], tripletValues[k]};
+        }
+
+        // Sort each row by column and merge duplicates
+        colIndex.reserve(count);
+        values.reserve(count);
+        int written = 0;
+        for (int i = 0; i < rows; ++i) {
+            auto first = entries.begin() + rowStart[i];
+            auto last = entries.begin() + rowStart[i + 1];
+            std::sort(first, last, [](const std::pair<int, double>& a, const std::pair<int, double>& b) {
+                return a.first < b.first;
+            });
+            rowStart[i] = written;
+            for (auto it = first; it != last; ++it) {
+                if (written > rowStart[i] && colIndex.back() == it->first) {
+                    values.back() += it->second;
+                } else {
+                    colIndex.push_back(it->first);
+                    values.push_back(it->second);
+                    written++;
+                }
+            }
+        }
+        rowStart[rows] = written;
+    }
+
+    // Build from a dense row-wise matrix, keeping only the nonzero entries
+    static SparseMatrix fromDense(const std::vector<std::vector<double>>& A) {
+        int rows = A.size();
+        int cols = rows > 0 ? A[0].size() : 0;
+        std::vector<int> r, c;
+        std::vector<double> v;
+        for (int i = 0; i < rows; ++i) {
+            for (int j = 0; j < cols; ++j) {
+                if (A[i][j] != 0.0) {
+                    r.push_back(i);
+                    c.push_back(j);
+                    v.push_back(A[i][j]);
+                }
+            }
+        }
+        return SparseMatrix(rows, cols, std::move(r), std::move(c), std::move(v));
+    }
+
+    int rows() const { return nRows; }
+    int cols() const { return nCols; }
+    size_t nonZeros() const { return values.size(); }
+
+    const std::vector<int>& rowPointers() const { return rowStart; }
+    const std::vector<int>& columns() const { return colIndex; }
+    const std::vector<double>& entries() const { return values; }
+
+    // Diagonal entries (zero where the diagonal is not stored)
+    std::vector<double> diagonal() const {
+        std::vector<double> d(nRows, 0.0);
+        for (int i = 0; i < nRows; ++i) {
+            for (int k = rowStart[i]; k < rowStart[i + 1]; ++k) {
+                if (colIndex[k] == i) {
+                    d[i] = values[k];
+                }
+            }
+        }
+        return d;
+    }
+
+    // y = A x, rows split across threads when built with OpenMP
+    void multiply(const std::vector<double>& x, std::vector<double>& y) const {
+        y.resize(nRows);
+        #pragma omp parallel for schedule(static)
+        for (int i = 0; i < nRows; ++i) {
+            double sum = 0.0;
+            for (int k = rowStart[i]; k < rowStart[i + 1]; ++k) {
+                sum += values[k] * x[colIndex[k]];
+            }
+            y[i] = sum;
+        }
+    }
+
+    SparseMatrix transposed() const {
+        std::vector<int> r(values.size()), c(values.size());
+        for (int i = 0; i < nRows; ++i) {
+            for (int k = rowStart[i]; k < rowStart[i + 1]; ++k) {
+                r[k] = colIndex[k];
+                c[k] = i;
+            }
+        }
+        return SparseMatrix(nCols, nRows, std::move(r), std::move(c), values);
+    }
+
+private:
+    int nRows, nCols;
+    std::vector<int> rowStart;
+    std::vector<int> colIndex;
+    std::vector<double> values;
+};
+
+// Read a sparse matrix from a Matrix Market coordinate file (.mtx).
+// Supports real, integer and pattern fields with general or symmetric
+// storage; symmetric files are expanded to both triangles.
+inline SparseMatrix readMatrixMarket(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("Cannot open Matrix Market file: " + path);
+    }
+
+    std::string line;
+    if (!std::getline(in, line)) {
+        throw std::runtime_error("Empty Matrix Market file: " + path);
+    }
+    std::string lower = line;
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char ch) { return std::tolower(ch); });
+    if (lower.compare(0, 14, "%%matrixmarket") != 0 || lower.find("coordinate") == std::string::npos) {
+        throw std::runtime_error("Only Matrix Market coordinate files are supported: " + path);
+    }
+    if (lower.find("complex") != std::string::npos) {
+        throw std::runtime_error("Complex Matrix Market files are not supported: " + path);
+    }
+    bool pattern = lower.find("pattern") != std::string::npos;
+    bool symmetric = lower.find("symmetric") != std::string::npos;
+    bool skew = lower.find("skew-symmetric") != std::string::npos;
+
+    while (std::getline(in, line) && (line.empty() || line[0] == '%')) {
+    }
+    int rows = 0, cols = 0;
+    long long count = 0;
+    std::istringstream header(line);
+    if (!(header >> rows >> cols >> count)) {
+        throw std::runtime_error("Invalid Matrix Market size line: " + path);
+    }
+
+    std::vector<int> r, c;
+    std::vector<double> v;
+    size_t capacity = (symmetric || skew) ? 2 * count : count;
+    r.reserve(capacity);
+    c.reserve(capacity);
+    v.reserve(capacity);
+    for (long long k = 0; k < count; ++k) {
+        int i, j;
+        double value = 1.0;
+        if (!(in >> i >> j) || (!pattern && !(in >> value))) {
+            throw std::runtime_error("Unexpected end of Matrix Market file: " + path);
+        }
+        r.push_back(i - 1);
+        c.push_back(j - 1);
+        v.push_back(value);
+        if ((symmetric || skew) && i != j) {
+            r.push_back(j - 1);
+            c.push_back(i - 1);
+            v.push_back(skew ? -value : value);
+        }
+    }
+    return SparseMatrix(rows, cols, std::move(r), std::move(c), std::move(v));
+}
+
+#endif
@@ -0,0 +1,198 @@
+#ifndef TRAJECTORY_WRITER_H
+#define TRAJECTORY_WRITER_H
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// Binary trajectory file written through a memory mapping (POSIX).
+//
+// Layout: a 32-byte header followed by `count` samples of two doubles (x, y)
+// in native byte order.
+//
+//   char     magic[8]   "TRAJv1"
+//   uint64_t count      number of samples
+//   uint64_t fields     doubles per sample (2)
+//   uint64_t dense      1 if samples were interpolated at requested times
+//
+// The file is preallocated and mapped; write() only stores two doubles, and
+// the mapping is doubled in size when it fills up. The file is truncated to
+// the samples actually written when the writer is closed.
+class TrajectoryWriter {
+public:
+    struct Header {
+        char magic[8];
+        uint64_t count;
+        uint64_t fields;
+        uint64_t dense;
+    };
+
+    TrajectoryWriter(const std::string& path, size_t capacity, bool dense = false)
+        : fd(-1), base(nullptr), mappedBytes(0), samples(nullptr), capacity(0), count(0), denseOutput(dense) {
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            fail("cannot open " + path);
+        }
+        map(std::max<size_t>(capacity, 1));
+    }
+
+    ~TrajectoryWriter() {
+        try {
+            close();
+        } catch (...) {
+        }
+    }
+
+    TrajectoryWriter(const TrajectoryWriter&) = delete;
+    TrajectoryWriter& operator=(const TrajectoryWriter&) = delete;
+
+    void write(double x, double y) {
+        if (count == capacity) {
+            map(2 * capacity);
+        }
+        samples[2 * count] = x;
+        samples[2 * count + 1] = y;
+        count++;
+    }
+
+    size_t size() const { return count; }
+
+    // Write the header, unmap and truncate the file to its final size
+    void close() {
+        if (fd < 0) {
+            return;
+        }
+        Header* header = static_cast<Header*>(base);
+        std::memset(header, 0, sizeof(Header));
+        std::memcpy(header->magic, "TRAJv1", 6);
+        header->count = count;
+        header->fields = 2;
+        header->dense = denseOutput ? 1 : 0;
+        ::munmap(base, mappedBytes);
+        int status = ::ftruncate(fd, sizeof(Header) + count * 2 * sizeof(double));
+        ::close(fd);
+        fd = -1;
+        base = nullptr;
+        if (status != 0) {
+            fail("cannot truncate trajectory file");
+        }
+    }
+
+private:
+    int fd;
+    void* base;
+    size_t mappedBytes;
+    double* samples;
+    size_t capacity;
+    size_t count;
+    bool denseOutput;
+
+    [[noreturn]] static void fail(const std::string& message) {
+        throw std::runtime_error("Trajectory file: " + message + " (" + std::strerror(errno) + ")");
+    }
+
+    void map(size_t newCapacity) {
+        if (base != nullptr) {
+            ::munmap(base, mappedBytes);
+            base = nullptr;
+        }
+        size_t bytes = sizeof(Header) + newCapacity * 2 * sizeof(double);
+        if (::ftruncate(fd, bytes) != 0) {
+            fail("cannot resize trajectory file");
+        }
+        void* address = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (address == MAP_FAILED) {
+            fail("cannot map trajectory file");
+        }
+        base = address;
+        mappedBytes = bytes;
+        samples = reinterpret_cast<double*>(static_cast<char*>(base) + sizeof(Header));
+        capacity = newCapacity;
+    }
+};
+
+// Output stage between an integrator and a TrajectoryWriter.
+// The integrator reports every step with the values and slopes at both ends
+// and calls finish() after the last one; the stage either writes every n-th
+// step and the final point, or writes the solution at the requested times
+// using cubic Hermite interpolation inside the step.
+class TrajectoryOutput {
+public:
+    // Write the initial point, every `every`-th step and the last step
+    TrajectoryOutput(TrajectoryWriter& writer, int every)
+        : writer(writer), every(std::max(every, 1)), stepCount(0), lastX(0), lastY(0), nextTime(0) {}
+
+    // Write the solution at the given times (dense output, forward integration)
+    TrajectoryOutput(TrajectoryWriter& writer, std::vector<double> times)
+        : writer(writer), every(0), stepCount(0), lastX(0), lastY(0), times(std::move(times)), nextTime(0) {
+        std::sort(this->times.begin(), this->times.end());
+    }
+
+    void start(double x, double y) {
+        if (every > 0) {
+            writer.write(x, y);
+            return;
+        }
+        while (nextTime < times.size() && times[nextTime] < x) {
+            nextTime++;  // Requested times before the start cannot be produced
+        }
+        while (nextTime < times.size() && times[nextTime] == x) {
+            writer.write(x, y);
+            nextTime++;
+        }
+    }
+
+    void step(double x0, double y0, double f0, double x1, double y1, double f1) {
+        if (every > 0) {
+            if (++stepCount % every == 0) {
+                writer.write(x1, y1);
+            }
+            lastX = x1;
+            lastY = y1;
+            return;
+        }
+        double h = x1 - x0;
+        if (h == 0) {
+            return;
+        }
+        // Small slack so a time equal to the end point is not lost to rounding in x
+        double slack = 1e-9 * std::fabs(h);
+        double lo = std::min(x0, x1) - slack, hi = std::max(x0, x1) + slack;
+        while (nextTime < times.size() && times[nextTime] >= lo && times[nextTime] <= hi) {
+            double t = (times[nextTime] - x0) / h;
+            double t2 = t * t, t3 = t2 * t;
+            double y = (2*t3 - 3*t2 + 1) * y0 + (t3 - 2*t2 + t) * h * f0
+                     + (-2*t3 + 3*t2) * y1 + (t3 - t2) * h * f1;
+            writer.write(times[nextTime], y);
+            nextTime++;
+        }
+    }
+
+    // End of the integration: in decimated mode, write the final point
+    // unless the step count was a multiple of `every`
+    void finish() {
+        if (every > 0 && stepCount % every != 0) {
+            writer.write(lastX, lastY);
+        }
+    }
+
+private:
+    TrajectoryWriter& writer;
+    int every;
+    long long stepCount;
+    double lastX, lastY;
+    std::vector<double> times;
+    size_t nextTime;
+};
+
+#endif
@@ -2,169 +2,77 @@
 #include <vector>
 #include <cmath>
 #include <stdexcept>
+#include <algorithm>
+#include <functional>
 
-using namespace std;
-
-// Function to multiply a matrix by a vector
-vector<double> matrixVectorMultiply(const vector<vector<double>> &matrix, const vector<double> &vec) {
-    int rows = matrix.size();
-    int cols = matrix[0].size();
-    vector<double> result(rows, 0.0);
-
-    for (int i = 0; i < rows; ++i) {
-        for (int j = 0; j < cols; ++j) {
-            result[i] += matrix[i][j] * vec[j];
-        }
-    }
+#include "batch_io.h"
+#include "dense_matrix.h"
+#include "eigen.h"
 
-    return result;
-}
-
-// Function to normalize a vector
-void normalize(vector<double> &vec) {
-    double norm = 0.0;
-    for (double val : vec) {
-        norm += val * val;
-    }
-    norm = sqrt(norm);
-    for (double &val : vec) {
-        val /= norm;
-    }
-}
-
-// Function to calculate the determinant of a matrix (assumes square matrix)
-double determinant(const vector<vector<double>> &matrix) {
-    if (matrix.size() != matrix[0].size()) {
-        throw runtime_error("Matrix must be square.");
-    }
-
-    int n = matrix.size();
-    vector<vector<double>> temp(matrix);
-    double det = 1.0;
+using namespace std;
 
-    for (int i = 0; i < n; ++i) {
-        int pivot = i;
-        for (int j = i + 1; j < n; ++j) {
-            if (fabs(temp[j][i]) > fabs(temp[pivot][i])) {
-                pivot = j;
+// Batch mode: each record is "n A(row-wise) v1 epsilon maxIterations shift
+// rayleigh" and the output line is the largest eigenvalue and the one
+// closest to the shift, both iterations starting from v1
+int runBatch(const string& path) {
+    RecordWriter out(cout);
+    try {
+        RecordReader in(path);
+        DenseMatrix A;
+        vector<double> start, v1;
+        while (!in.atEnd()) {
+            int n = in.integer();
+            if (n <= 0) {
+                in.fail("invalid size");
             }
-        }
-
-        if (fabs(temp[pivot][i]) < 1e-10) {
-            return 0.0;
-        }
-
-        if (i != pivot) {
-            swap(temp[i], temp[pivot]);
-            det = -det;
-        }
-
-        det *= temp[i][i];
-
-        for (int j = i + 1; j < n; ++j) {
-            temp[j][i] /= temp[i][i];
-            for (int k = i + 1; k < n; ++k) {
-                temp[j][k] -= temp[j][i] * temp[i][k];
+            if (A.rows() != n) {
+                A = DenseMatrix(n, n);
+                start.resize(n);
             }
-        }
-    }
-
-    return det;
-}
-
-// Function to calculate the inverse of a matrix (assumes square matrix)
-vector<vector<double>> inverse(const vector<vector<double>> &matrix) {
-    if (matrix.size() != matrix[0].size()) {
-        throw runtime_error("Matrix must be square.");
-    }
-
-    int n = matrix.size();
-    vector<vector<double>> result(n, vector<double>(n, 0.0));
-    vector<vector<double>> temp(matrix);
-
-    for (int i = 0; i < n; ++i) {
-        result[i][i] = 1.0;
-    }
-
-    for (int i = 0; i < n; ++i) {
-        int pivot = i;
-        for (int j = i + 1; j < n; ++j) {
-            if (fabs(temp[j][i]) > fabs(temp[pivot][i])) {
-                pivot = j;
-            }
-        }
-
-        if (fabs(temp[pivot][i]) < 1e-10) {
-            throw runtime_error("Matrix is singular and cannot be inverted.");
-        }
-
-        swap(temp[i], temp[pivot]);
-        swap(result[i], result[pivot]);
-
-        double div = temp[i][i];
-        for (int j = 0; j < n; ++j) {
-            temp[i][j] /= div;
-            result[i][j] /= div;
-        }
-
-        for (int j = 0; j < n; ++j) {
-            if (j != i) {
-                double factor = temp[j][i];
-                for (int k = 0; k < n; ++k) {
-                    temp[j][k] -= factor * temp[i][k];
-                    result[j][k] -= factor * result[i][k];
-                }
+            in.numbers(A.data(), static_cast<size_t>(n) * n);
+            in.numbers(start.data(), n);
+            double epsilon = in.number();
+            int maxIterations = in.integer();
+            double shift = in.number();
+            bool rayleigh = in.integer() == 1;
+
+            try {
+                v1 = start;
+                double largestEigenvalue = powerIteration(A, v1, epsilon, maxIterations);
+                v1 = start;
+                double nearestEigenvalue = inverseIteration(A, v1, shift, epsilon, rayleigh, maxIterations);
+                out.number(largestEigenvalue).number(nearestEigenvalue);
+                out.endRecord();
+            } catch (runtime_error &e) {
+                out.error(e.what());
             }
         }
+    } catch (runtime_error &e) {
+        out.flush();
+        cerr << e.what() << endl;
+        return -1;
     }
-
-    return result;
+    return 0;
 }
 
-// Function to calculate the largest eigenvalue using power iteration
-double powerIteration(const vector<vector<double>> &matrix, vector<double> &vec, double epsilon) {
-    vector<double> oldVec = vec;
-    vector<double> newVec = matrixVectorMultiply(matrix, vec);
-    normalize(newVec);
-
-    int iterations = 0;
-    while (true) {
-        vec = newVec;
-        newVec = matrixVectorMultiply(matrix, vec);
-        normalize(newVec);
-
-        double diff = 0.0;
-        for (int i = 0; i < vec.size(); ++i) {
-            diff += fabs(newVec[i] - vec[i]);
-        }
-
-        iterations++;
-        if (diff < epsilon || iterations >= 1000) { // safety cap on iterations
-            break;
-        }
-    }
-
-    vector<double> result = matrixVectorMultiply(matrix, vec);
-    double eigenvalue = 0.0;
-    for (int i = 0; i < vec.size(); ++i) {
-        eigenvalue += vec[i] * result[i];
+int main(int argc, char** argv) {
+    BatchOptions batch;
+    if (batchMode(argc, argv, batch)) {
+        return runBatchMode(batch, runBatch);
     }
-    return eigenvalue;
-}
 
-int main() {
     int n;
     cout << "Enter the size of the matrix: ";
     cin >> n;
 
-    vector<vector<double>> A(n, vector<double>(n));
+    DenseMatrix A(n, n);
     vector<double> v1(n);
     double epsilon;
 
     cout << "Enter the elements of the matrix (row-wise):\n";
     for (int i = 0; i < n; ++i) {
         for (int j = 0; j < n; ++j) {
-            cin >> A[i][j];
+            cin >> A(i, j);
         }
     }
 
@@ -176,7 +84,11 @@ int main() {
     cout << "Enter the epsilon value: ";
     cin >> epsilon;
 
-    double largestEigenvalue = powerIteration(A, v1, epsilon);
+    int maxIterations;
+    cout << "Enter the maximum number of iterations: ";
+    cin >> maxIterations;
+
+    double largestEigenvalue = powerIteration(A, v1, epsilon, maxIterations);
 
     // Reset the vector v1 for smallest eigenvalue calculation
     cout << "Enter the initial vector again for smallest eigenvalue calculation:\n";
@@ -184,19 +96,57 @@ int main() {
         cin >> v1[i];
     }
 
-    // Inverse of matrix A
-    vector<vector<double>> A_inv;
+    double shift;
+    cout << "Enter the shift sigma (0 for the smallest eigenvalue in magnitude): ";
+    cin >> shift;
+
+    int rayleigh;
+    cout << "Use Rayleigh quotient updates? (1 = yes, 0 = no): ";
+    cin >> rayleigh;
+
+    // Inverse iteration on LU factors of (A - sigma * I)
+    double nearestEigenvalue;
     try {
-        A_inv = inverse(A);
+        nearestEigenvalue = inverseIteration(A, v1, shift, epsilon, rayleigh == 1, maxIterations);
     } catch (runtime_error &e) {
         cerr << e.what() << endl;
         return -1;
     }
 
-    double smallestEigenvalue = 1.0 / powerIteration(A_inv, v1, epsilon);
+    int k;
+    cout << "Enter the number of leading eigenpairs to compute (0 to skip): ";
+    cin >> k;
+    EigenPairs pairs;
+    if (k > 0) {
+        int method;
+        cout << "Choose method:\n1. Subspace (block power) iteration\n2. Thick-restart Lanczos\n";
+        cin >> method;
+        k = min(k, n);
+        try {
+            if (method == 1) {
+                pairs = subspaceIteration(denseOperator(A), n, k, epsilon, maxIterations);
+            } else {
+                pairs = lanczos(denseOperator(A), n, k, epsilon, maxIterations);
+            }
+        } catch (runtime_error &e) {
+            cerr << e.what() << endl;
+            return -1;
+        }
+    }
 
     cout << "Approximate largest eigenvalue: " << largestEigenvalue << endl;
-    cout << "Approximate smallest eigenvalue: " << smallestEigenvalue << endl;
+    if (shift == 0.0) {
+        cout << "Approximate smallest eigenvalue: " << nearestEigenvalue << endl;
+    } else {
+        cout << "Approximate eigenvalue closest to " << shift << ": " << nearestEigenvalue << endl;
+    }
+    if (k > 0) {
+        cout << "Leading " << k << " eigenvalues (" << pairs.matvecs << " matrix-vector products, "
+             << (pairs.converged ? "converged" : "not converged") << "):" << endl;
+        for (int i = 0; i < k; ++i) {
+            cout << "  " << pairs.values[i] << endl;
+        }
+    }
 
     return 0;
 }